@@ -0,0 +1,300 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Per-function evaluation throughput
+ *
+ * Measures ns/eval and evals/second of every function, in float and double,
+ * through five paths:
+ *  - scalar:     the function template called directly in a loop (inlined)
+ *  - registry:   eval_function(id, theta, phi), one table lookup per call
+ *  - batch:      eval_batch over angles, the dispatched SIMD kernel
+ *  - batch_xyz:  eval_batch_xyz over unit vectors
+ *  - batch_fast: eval_batch with the fast_math policy
+ * and the fused evaluators, which produce all functions at once (reported as
+ * function "all", per function and point).
+ * Points are uniformly distributed random directions, as drawn by the Monte
+ * Carlo integrator, or an equiangular (theta, phi) grid as used for tables.
+ * Each measurement is the best of several repeats, each at least min_time long.
+ *
+ * Usage:
+ *   benchmark [--points N] [--repeats R] [--min-time SECONDS]
+ *             [--simd generic|sse42|avx2|avx512] [--output FILE]
+ *
+ * Results are written as JSON to stdout, or to FILE.
+ */
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <numbers>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+
+#include <functions.h>
+#include <fused.h>
+#include <montecarlo.h>
+
+namespace
+{
+
+struct options
+{
+    std::size_t points = 1 << 14;
+    int repeats = 5;
+    double min_time = 0.02;
+    std::string output;
+};
+
+struct point_set
+{
+    char const* name;
+    std::vector<double> theta, phi, x, y, z;
+};
+
+struct measurement
+{
+    std::string_view function;
+    char const* type;
+    char const* path;
+    char const* distribution;
+    double ns_per_eval;
+};
+
+template<typename Float>
+struct typed_points
+{
+    std::vector<Float> theta, phi, x, y, z, out;
+
+    explicit typed_points(point_set const& p)
+        : theta(p.theta.begin(), p.theta.end()), phi(p.phi.begin(), p.phi.end()),
+          x(p.x.begin(), p.x.end()), y(p.y.begin(), p.y.end()), z(p.z.begin(), p.z.end()),
+          out(p.theta.size())
+    {
+    }
+};
+
+point_set uniform_points(std::size_t const n)
+{
+    point_set p{ "uniform", {}, {}, std::vector<double>(n), std::vector<double>(n), std::vector<double>(n) };
+    sphc::montecarlo::sample_block<double>(0, 0, p.x, p.y, p.z);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        p.theta.push_back(std::atan2(std::sqrt(p.x[i] * p.x[i] + p.y[i] * p.y[i]), p.z[i]));
+        p.phi.push_back(std::atan2(p.y[i], p.x[i]));
+    }
+    return p;
+}
+
+point_set grid_points(std::size_t const n)
+{
+    std::size_t const rows = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(n / 2.0)));
+    std::size_t const columns = (n + rows - 1) / rows;
+
+    point_set p{ "grid", {}, {}, {}, {}, {} };
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        double const theta = (static_cast<double>(k / columns) + 0.5) * std::numbers::pi / static_cast<double>(rows);
+        double const phi = static_cast<double>(k % columns) * 2.0 * std::numbers::pi / static_cast<double>(columns);
+        p.theta.push_back(theta);
+        p.phi.push_back(phi);
+        p.x.push_back(std::sin(theta) * std::cos(phi));
+        p.y.push_back(std::sin(theta) * std::sin(phi));
+        p.z.push_back(std::cos(theta));
+    }
+    return p;
+}
+
+/**
+ * Best time per evaluation over the repeats, in nanoseconds
+ */
+template<typename Body>
+double time_per_eval(options const& opt, std::size_t const n, Body&& body)
+{
+    using clock = std::chrono::steady_clock;
+
+    double best = 1e300;
+    for (int r = 0; r < opt.repeats; ++r)
+    {
+        std::size_t evals = 0;
+        auto const start = clock::now();
+        double elapsed = 0.0;
+        do
+        {
+            body();
+            evals += n;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        }
+        while (elapsed < opt.min_time);
+        best = std::min(best, elapsed * 1e9 / static_cast<double>(evals));
+    }
+    return best;
+}
+
+// keeps the results observable so the evaluation loops are not removed
+double volatile sink;
+
+template<typename Float, std::size_t I>
+void bench_function(options const& opt, point_set const& set, typed_points<Float>& p, char const* type,
+    std::vector<measurement>& results)
+{
+    sphc::FunctionId constexpr id = static_cast<sphc::FunctionId>(I);
+    sphc::function<Float> constexpr scalar = sphc::get_function<Float>(id);
+    std::string_view const name = sphc::function_name(id);
+    std::size_t const n = p.theta.size();
+
+    double const ns_scalar = time_per_eval(opt, n, [&]()
+    {
+        Float acc = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            acc += scalar(p.theta[i], p.phi[i]);
+        sink = static_cast<double>(acc);
+    });
+
+    // a constant id would fold the lookup into a direct call; read through a
+    // volatile, every call pays for the table lookup and the indirect call
+    sphc::FunctionId volatile const registry_id = id;
+    double const ns_registry = time_per_eval(opt, n, [&]()
+    {
+        Float acc = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            acc += sphc::eval_function<Float>(registry_id, p.theta[i], p.phi[i]);
+        sink = static_cast<double>(acc);
+    });
+
+    double const ns_batch = time_per_eval(opt, n, [&]()
+    {
+        sphc::eval_batch<Float>(id, p.theta, p.phi, p.out);
+        sink = static_cast<double>(p.out[n / 2]);
+    });
+
+    double const ns_batch_xyz = time_per_eval(opt, n, [&]()
+    {
+        sphc::eval_batch_xyz<Float>(id, p.x, p.y, p.z, p.out);
+        sink = static_cast<double>(p.out[n / 2]);
+    });
+
+    double const ns_batch_fast = time_per_eval(opt, n, [&]()
+    {
+        sphc::eval_batch<Float, sphc::fast_math>(id, p.theta, p.phi, p.out);
+        sink = static_cast<double>(p.out[n / 2]);
+    });
+
+    results.push_back({ name, type, "scalar", set.name, ns_scalar });
+    results.push_back({ name, type, "registry", set.name, ns_registry });
+    results.push_back({ name, type, "batch", set.name, ns_batch });
+    results.push_back({ name, type, "batch_xyz", set.name, ns_batch_xyz });
+    results.push_back({ name, type, "batch_fast", set.name, ns_batch_fast });
+}
+
+template<typename Float, std::size_t... I>
+void bench_all(options const& opt, point_set const& set, char const* type, std::vector<measurement>& results,
+    std::index_sequence<I...>)
+{
+    typed_points<Float> p(set);
+    (bench_function<Float, I>(opt, set, p, type, results), ...);
+
+    std::size_t const n = p.theta.size();
+    std::vector<Float> all(sphc::function_count * n);
+    double const ns_fused = time_per_eval(opt, n * sphc::function_count, [&]()
+    {
+        sphc::eval_fused<Float>(p.theta, p.phi, all);
+        sink = static_cast<double>(all[n / 2]);
+    });
+    double const ns_fused_xyz = time_per_eval(opt, n * sphc::function_count, [&]()
+    {
+        sphc::eval_fused_xyz<Float>(p.x, p.y, p.z, all);
+        sink = static_cast<double>(all[n / 2]);
+    });
+    results.push_back({ "all", type, "fused", set.name, ns_fused });
+    results.push_back({ "all", type, "fused_xyz", set.name, ns_fused_xyz });
+}
+
+char const* simd_level_name(sphc::simd_level const level)
+{
+    switch (level)
+    {
+        case sphc::simd_level::sse42: return "sse42";
+        case sphc::simd_level::avx2: return "avx2";
+        case sphc::simd_level::avx512: return "avx512";
+        default: return "generic";
+    }
+}
+
+void write_json(std::FILE* out, options const& opt, std::vector<measurement> const& results)
+{
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"simd_level\": \"%s\",\n", simd_level_name(sphc::active_simd_level()));
+    std::fprintf(out, "  \"points\": %zu,\n", opt.points);
+    std::fprintf(out, "  \"repeats\": %d,\n", opt.repeats);
+    std::fprintf(out, "  \"results\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        measurement const& m = results[i];
+        std::fprintf(out,
+            "    { \"function\": \"%.*s\", \"type\": \"%s\", \"path\": \"%s\", \"distribution\": \"%s\", "
+            "\"ns_per_eval\": %.4f, \"evals_per_second\": %.6e }%s\n",
+            static_cast<int>(m.function.size()), m.function.data(), m.type, m.path, m.distribution,
+            m.ns_per_eval, 1e9 / m.ns_per_eval, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string_view const arg = argv[i];
+        if (arg == "--points")
+            opt.points = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        else if (arg == "--repeats")
+            opt.repeats = std::max(1, std::atoi(argv[i + 1]));
+        else if (arg == "--min-time")
+            opt.min_time = std::atof(argv[i + 1]);
+        else if (arg == "--output")
+            opt.output = argv[i + 1];
+        else if (arg == "--simd")
+        {
+            std::string_view const level = argv[i + 1];
+            sphc::set_simd_level(level == "avx512" ? sphc::simd_level::avx512 :
+                level == "avx2" ? sphc::simd_level::avx2 :
+                level == "sse42" ? sphc::simd_level::sse42 : sphc::simd_level::generic);
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<measurement> results;
+    auto constexpr ids = std::make_index_sequence<sphc::function_count>();
+    for (point_set const& set : { uniform_points(opt.points), grid_points(opt.points) })
+    {
+        bench_all<float>(opt, set, "float", results, ids);
+        bench_all<double>(opt, set, "double", results, ids);
+    }
+
+    std::FILE* out = opt.output.empty() ? stdout : std::fopen(opt.output.c_str(), "w");
+    if (out == nullptr)
+    {
+        std::fprintf(stderr, "cannot open %s\n", opt.output.c_str());
+        return 1;
+    }
+    write_json(out, opt, results);
+    if (out != stdout)
+        std::fclose(out);
+    return 0;
+}
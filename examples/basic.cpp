@@ -4,6 +4,7 @@
  * Copyright (c) 2025-2026, Michal Vlnas
  */
 
+#include <vector>
 #include <iostream>
 #include <functions.h>
 
@@ -21,5 +22,13 @@ int main()
     auto const val4 = sphc::eval_function("l1", 0.123, 0.345);
     std::cout << val4 << std::endl;
 
+    std::vector<double> theta = { 0.123, 0.5, 1.0 };
+    std::vector<double> phi = { 0.345, 1.0, 2.0 };
+    std::vector<double> out(theta.size());
+    sphc::eval_batch<double>("l1", theta, phi, out);
+    for (double const v : out)
+        std::cout << v << " ";
+    std::cout << std::endl;
+
     return 0;
 }
@@ -0,0 +1,427 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_ADAPTIVE_H
+#define SPHERICAL_COLLECTION_ADAPTIVE_H
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include "functions.h"
+#include "parallel.h"
+#include "quadrature.h"
+
+namespace sphc
+{
+
+/**
+ * Adaptive integration over spherical triangles
+ *
+ * The sphere starts as the 20 faces of an icosahedron. Each spherical triangle
+ * is integrated by the degree 5 Radon rule through the radial projection of
+ * its flat triangle, once over the whole triangle and once over its four
+ * children (split at the great circle midpoints of the edges). The difference
+ * is the error estimate of the triangle and the children sum its value. The
+ * triangles with the largest errors are refined in parallel batches until the
+ * total error meets the tolerance.
+ *
+ * The estimate only sees what the nodes see: a kink or jump that cuts off the
+ * corner of a triangle between its nodes is missed by both rule values, so for
+ * a1 - a6 and d4 the true error can exceed the estimate by orders of magnitude.
+ * Integrating a function of the collection therefore reports convergence only
+ * when no triangle straddles such a feature.
+ */
+namespace adaptive
+{
+
+struct options
+{
+    double absolute_tolerance = 1e-10;
+    double relative_tolerance = 1e-10;
+    std::size_t max_evaluations = 20'000'000;
+    std::size_t batch = 256;            // triangles refined per parallel step
+    unsigned threads = 0;               // 0 for hardware concurrency
+};
+
+template<typename Float>
+struct result
+{
+    Float estimate;             // surface integral estimate
+    Float error;                // estimated absolute error
+    std::size_t triangles;      // leaves of the final subdivision
+    std::size_t evaluations;
+    bool converged;             // the tolerance was met within max_evaluations, by an estimate that holds
+};
+
+namespace
+{
+
+template<typename Float>
+using point = std::array<Float, 3>;
+
+template<typename Float>
+point<Float> unit(Float const x, Float const y, Float const z)
+{
+    Float const len = std::sqrt(x * x + y * y + z * z);
+    return { x / len, y / len, z / len };
+}
+
+template<typename Float>
+point<Float> arc_midpoint(point<Float> const& a, point<Float> const& b)
+{
+    return unit(a[0] + b[0], a[1] + b[1], a[2] + b[2]);
+}
+
+template<typename Float>
+struct triangle
+{
+    point<Float> a, b, c;
+};
+
+// the children in the order of quadrature::add_icosahedral_triangle
+template<typename Float>
+std::array<triangle<Float>, 4> split(triangle<Float> const& t)
+{
+    point<Float> const ab = arc_midpoint(t.a, t.b);
+    point<Float> const bc = arc_midpoint(t.b, t.c);
+    point<Float> const ca = arc_midpoint(t.c, t.a);
+    return { { { t.a, ab, ca }, { ab, t.b, bc }, { ca, bc, t.c }, { ab, bc, ca } } };
+}
+
+/**
+ * Radon's 7 point degree 5 rule on the reference triangle, barycentric
+ * coordinates and weights summing to one
+ */
+template<typename Float>
+struct radon_rule
+{
+    std::array<std::array<Float, 3>, 7> nodes;
+    std::array<Float, 7> weights;
+
+    radon_rule()
+    {
+        Float const r = std::sqrt(Float(15));
+        Float const a = (6 - r) / 21, b = (6 + r) / 21;
+        Float const wa = (155 - r) / 1200, wb = (155 + r) / 1200;
+        nodes = { { { Float(1) / 3, Float(1) / 3, Float(1) / 3 },
+                    { a, a, 1 - 2 * a }, { a, 1 - 2 * a, a }, { 1 - 2 * a, a, a },
+                    { b, b, 1 - 2 * b }, { b, 1 - 2 * b, b }, { 1 - 2 * b, b, b } } };
+        weights = { Float(9) / 40, wa, wa, wa, wb, wb, wb };
+    }
+};
+
+template<typename Float>
+radon_rule<Float> const& get_radon_rule()
+{
+    static radon_rule<Float> const rule;
+    return rule;
+}
+
+/**
+ * Nodes of the rule on a spherical triangle and their weights times the area
+ * element, dA = |N . a| / |q|^3 du dv for the flat point q and flat normal N
+ */
+template<typename Float>
+void rule_nodes(triangle<Float> const& t, Float* x, Float* y, Float* z, Float* w)
+{
+    radon_rule<Float> const& rule = get_radon_rule<Float>();
+    point<Float> const e1 = { t.b[0] - t.a[0], t.b[1] - t.a[1], t.b[2] - t.a[2] };
+    point<Float> const e2 = { t.c[0] - t.a[0], t.c[1] - t.a[1], t.c[2] - t.a[2] };
+    Float const normal_a = std::abs(
+        (e1[1] * e2[2] - e1[2] * e2[1]) * t.a[0] +
+        (e1[2] * e2[0] - e1[0] * e2[2]) * t.a[1] +
+        (e1[0] * e2[1] - e1[1] * e2[0]) * t.a[2]);
+
+    for (std::size_t i = 0; i < 7; ++i)
+    {
+        auto const& l = rule.nodes[i];
+        Float const qx = l[0] * t.a[0] + l[1] * t.b[0] + l[2] * t.c[0];
+        Float const qy = l[0] * t.a[1] + l[1] * t.b[1] + l[2] * t.c[1];
+        Float const qz = l[0] * t.a[2] + l[1] * t.b[2] + l[2] * t.c[2];
+        Float const len = std::sqrt(qx * qx + qy * qy + qz * qz);
+        x[i] = qx / len;
+        y[i] = qy / len;
+        z[i] = qz / len;
+        // the reference triangle has area 1/2
+        w[i] = rule.weights[i] * normal_a / (2 * len * len * len);
+    }
+}
+
+template<typename Float>
+struct leaf
+{
+    triangle<Float> t;
+    std::array<Float, 4> children;      // rule values of the four children
+    Float value;                        // sum of the children
+    Float error;                        // |value - rule value of the triangle|
+};
+
+template<typename Float>
+bool smaller_error(leaf<Float> const& l, leaf<Float> const& r)
+{
+    return l.error < r.error;
+}
+
+/**
+ * Integrate the four children of a triangle whose own rule value is known;
+ * eval(x, y, z, out) evaluates the function over spans of unit vectors
+ */
+template<typename Float, typename Eval>
+leaf<Float> make_leaf(triangle<Float> const& t, Float const coarse, Eval const& eval)
+{
+    Float x[28], y[28], z[28], w[28], f[28];
+    std::array<triangle<Float>, 4> const children = split(t);
+    for (std::size_t k = 0; k < 4; ++k)
+        rule_nodes(children[k], x + 7 * k, y + 7 * k, z + 7 * k, w + 7 * k);
+    eval(std::span<Float const>(x), std::span<Float const>(y), std::span<Float const>(z), std::span<Float>(f));
+
+    leaf<Float> l{ t, {}, 0, 0 };
+    for (std::size_t k = 0; k < 4; ++k)
+    {
+        Float sum = 0;
+        for (std::size_t i = 0; i < 7; ++i)
+            sum += w[7 * k + i] * f[7 * k + i];
+        l.children[k] = sum;
+        l.value += sum;
+    }
+    l.error = std::abs(l.value - coarse);
+    return l;
+}
+
+template<typename Float, typename Eval>
+Float rule_value(triangle<Float> const& t, Eval const& eval)
+{
+    Float x[7], y[7], z[7], w[7], f[7];
+    rule_nodes(t, x, y, z, w);
+    eval(std::span<Float const>(x), std::span<Float const>(y), std::span<Float const>(z), std::span<Float>(f));
+
+    Float sum = 0;
+    for (std::size_t i = 0; i < 7; ++i)
+        sum += w[i] * f[i];
+    return sum;
+}
+
+/**
+ * Cut a triangle by the great circle n . p = 0 into triangles on either side;
+ * the pieces are convex and fanned from their first vertex
+ */
+template<typename Float>
+void split_by_plane(triangle<Float> const& t, point<Float> const& n, std::vector<triangle<Float>>& out)
+{
+    std::array<point<Float>, 3> const v = { t.a, t.b, t.c };
+    std::array<Float, 3> s;
+    for (std::size_t i = 0; i < 3; ++i)
+        s[i] = n[0] * v[i][0] + n[1] * v[i][1] + n[2] * v[i][2];
+
+    if ((s[0] >= 0 && s[1] >= 0 && s[2] >= 0) || (s[0] <= 0 && s[1] <= 0 && s[2] <= 0))
+    {
+        out.push_back(t);
+        return;
+    }
+
+    std::vector<point<Float>> sides[2];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        std::size_t const j = (i + 1) % 3;
+        if (s[i] >= 0)
+            sides[0].push_back(v[i]);
+        if (s[i] <= 0)
+            sides[1].push_back(v[i]);
+        if ((s[i] > 0 && s[j] < 0) || (s[i] < 0 && s[j] > 0))
+        {
+            // point of the edge arc on the circle
+            point<Float> const p = unit(s[i] * v[j][0] - s[j] * v[i][0], s[i] * v[j][1] - s[j] * v[i][1],
+                s[i] * v[j][2] - s[j] * v[i][2]);
+            point<Float> const q = s[i] > 0 ? p : point<Float>{ -p[0], -p[1], -p[2] };
+            sides[0].push_back(q);
+            sides[1].push_back(q);
+        }
+    }
+
+    for (auto const& polygon : sides)
+        for (std::size_t i = 1; i + 1 < polygon.size(); ++i)
+            out.push_back({ polygon[0], polygon[i], polygon[i + 1] });
+}
+
+template<typename Float, typename Eval>
+result<Float> integrate_triangles(std::vector<triangle<Float>> const& initial, options const& opt, Eval const& eval)
+{
+    std::size_t evaluations = 0;
+    std::vector<leaf<Float>> leaves(initial.size());
+    parallel_for(initial.size(), opt.threads, false, [&](std::size_t const i, unsigned)
+    {
+        leaves[i] = make_leaf(initial[i], rule_value(initial[i], eval), eval);
+    });
+    evaluations += initial.size() * 35;
+
+    Float value = 0, error = 0;
+    auto totals = [&]()
+    {
+        value = 0;
+        error = 0;
+        for (leaf<Float> const& l : leaves)
+        {
+            value += l.value;
+            error += l.error;
+        }
+    };
+    totals();
+    std::make_heap(leaves.begin(), leaves.end(), smaller_error<Float>);
+
+    std::size_t const batch = std::max<std::size_t>(opt.batch, 1);
+    std::size_t recount = 2 * leaves.size();
+    std::vector<leaf<Float>> worst, refined;
+    auto done = [&]()
+    {
+        return static_cast<double>(error) <=
+            std::max(opt.absolute_tolerance, opt.relative_tolerance * std::abs(static_cast<double>(value)));
+    };
+
+    while (!done() && evaluations + batch * 112 <= opt.max_evaluations)
+    {
+        worst.clear();
+        while (worst.size() < batch && !leaves.empty())
+        {
+            std::pop_heap(leaves.begin(), leaves.end(), smaller_error<Float>);
+            worst.push_back(leaves.back());
+            leaves.pop_back();
+        }
+
+        refined.resize(4 * worst.size());
+        parallel_for(worst.size(), opt.threads, false, [&](std::size_t const i, unsigned)
+        {
+            std::array<triangle<Float>, 4> const children = split(worst[i].t);
+            for (std::size_t k = 0; k < 4; ++k)
+                refined[4 * i + k] = make_leaf(children[k], worst[i].children[k], eval);
+        });
+        evaluations += worst.size() * 112;
+
+        for (leaf<Float> const& l : worst)
+        {
+            value -= l.value;
+            error -= l.error;
+        }
+        for (leaf<Float> const& l : refined)
+        {
+            value += l.value;
+            error += l.error;
+            leaves.push_back(l);
+            std::push_heap(leaves.begin(), leaves.end(), smaller_error<Float>);
+        }
+
+        // the running totals drift, sum them afresh whenever the leaves double
+        if (leaves.size() >= recount)
+        {
+            totals();
+            recount = 2 * leaves.size();
+        }
+    }
+
+    totals();
+    return { value, error, leaves.size(), evaluations, done() };
+}
+
+template<typename Float>
+std::vector<triangle<Float>> icosahedral_triangles()
+{
+    std::vector<quadrature::vec3> vertices;
+    std::vector<std::array<std::size_t, 3>> faces;
+    quadrature::icosahedron(vertices, faces);
+
+    std::vector<point<Float>> points;
+    for (quadrature::vec3 const& v : vertices)
+        points.push_back(unit(static_cast<Float>(v[0]), static_cast<Float>(v[1]), static_cast<Float>(v[2])));
+
+    std::vector<triangle<Float>> triangles;
+    for (auto const& f : faces)
+        triangles.push_back({ points[f[0]], points[f[1]], points[f[2]] });
+    return triangles;
+}
+
+} // namespace
+
+/**
+ * Integrate any function of (theta, phi), such as one from get_function
+ *
+ * @param fn Function to integrate
+ * @param opt Tolerances, evaluation budget and threading
+ * @return Estimate, its estimated error and the work done
+ */
+template<typename Float>
+result<Float> integrate(function<Float> const fn, options const& opt = {})
+{
+    auto const eval = [fn](std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+        std::span<Float> out)
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            auto const [theta, phi] = xyz_to_spherical<Float>(x[i], y[i], z[i]);
+            out[i] = fn(theta, phi);
+        }
+    };
+    return integrate_triangles(icosahedral_triangles<Float>(), opt, eval);
+}
+
+/**
+ * Integrate a function of the collection through its batch kernel
+ *
+ * The initial triangles of functions that jump across a great circle (see
+ * get_discontinuity_plane) are cut along it, so no triangle straddles the
+ * discontinuity and refinement only follows the smooth parts.
+ *
+ * The result is reported converged only if the function is smooth on every
+ * triangle, so that its error estimate can be trusted: for kinks, jumps at the
+ * poles and the jump of d4 across a plane off the origin it is not, even when
+ * the estimate meets the tolerance.
+ *
+ * @param id The identifier of the function
+ * @param opt Tolerances, evaluation budget and threading
+ * @return Estimate, its estimated error and the work done
+ */
+template<typename Float>
+result<Float> integrate(FunctionId const id, options const& opt = {})
+{
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+    std::vector<triangle<Float>> triangles = icosahedral_triangles<Float>();
+
+    std::optional<discontinuity_plane> const plane = get_discontinuity_plane(id);
+    bool const cut_along_plane = plane && plane->offset == 0.0;
+    if (cut_along_plane)
+    {
+        point<Float> const n = { static_cast<Float>(plane->nx), static_cast<Float>(plane->ny),
+            static_cast<Float>(plane->nz) };
+        std::vector<triangle<Float>> cut;
+        for (triangle<Float> const& t : triangles)
+            split_by_plane(t, n, cut);
+        triangles = std::move(cut);
+    }
+
+    smoothness const regularity = get_metadata(id).regularity;
+    bool const smooth_on_triangles = regularity == smoothness::analytic || regularity == smoothness::steep ||
+        (regularity == smoothness::jump && cut_along_plane);
+
+    result<Float> r = integrate_triangles(triangles, opt, fn);
+    r.converged = r.converged && smooth_on_triangles;
+    return r;
+}
+
+template<typename Float>
+result<Float> integrate(std::string_view const id, options const& opt = {})
+{
+    return integrate<Float>(function_id(id), opt);
+}
+
+} // namespace adaptive
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_ADAPTIVE_H
@@ -0,0 +1,556 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_AUTODIFF_H
+#define SPHERICAL_COLLECTION_AUTODIFF_H
+
+#include <span>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
+#include "vmath.h"
+#include "functions.h"
+
+namespace sphc
+{
+
+/**
+ * Forward-mode automatic differentiation of the function templates
+ *
+ * dual<T, N> carries a value and N partial derivatives and is a drop-in Float
+ * for the templates, with dual_math as their Math policy. Seeding x, y and z
+ * gives the ambient gradient in the same pass as the value; nesting the type,
+ * dual<dual<T, 3>, 3>, adds the ambient Hessian.
+ *
+ * On the unit sphere the surface gradient is the tangential part of the
+ * ambient one, P g with P = I - p p^T, and the surface Hessian is
+ * P H P - (g . p) P. Both depend only on the values on the sphere, so any
+ * extension of a function off the sphere gives the same result.
+ *
+ * The batch evaluators run through the dispatched SIMD kernels, so one point
+ * is a vector lane: the duals are flattened into scalar registers and the
+ * loop is vectorized 4 (AVX2) or 8 (AVX-512) doubles wide.
+ *
+ * Functions that are not smooth everywhere (see get_metadata) get the
+ * derivatives of the piece containing the point: zero across a jump, one-sided
+ * at a kink. At the poles the functions defined through angles may be
+ * infinite or NaN.
+ */
+namespace autodiff
+{
+
+namespace
+{
+
+// calls fn(0) ... fn(N - 1), unrolled at compile time so kernels stay a single
+// loop over the points
+template<std::size_t N, typename Fn>
+constexpr void for_each_derivative(Fn&& fn)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>) { (fn(I), ...); }(std::make_index_sequence<N>{});
+}
+
+}
+
+/**
+ * Value and N partial derivatives
+ */
+template<typename T, std::size_t N>
+struct dual
+{
+    T value;
+    std::array<T, N> d;
+
+    constexpr dual() : value(), d() {}
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    constexpr dual(S const v) : value(static_cast<T>(v)), d() {}
+
+    constexpr dual(T const& v, std::array<T, N> const& derivatives) : value(v), d(derivatives) {}
+
+    friend constexpr dual operator-(dual const& a)
+    {
+        dual r;
+        r.value = -a.value;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = -a.d[i]; });
+        return r;
+    }
+
+    friend constexpr dual operator+(dual const& a, dual const& b)
+    {
+        dual r;
+        r.value = a.value + b.value;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = a.d[i] + b.d[i]; });
+        return r;
+    }
+
+    friend constexpr dual operator-(dual const& a, dual const& b)
+    {
+        dual r;
+        r.value = a.value - b.value;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = a.d[i] - b.d[i]; });
+        return r;
+    }
+
+    friend constexpr dual operator*(dual const& a, dual const& b)
+    {
+        dual r;
+        r.value = a.value * b.value;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = a.d[i] * b.value + a.value * b.d[i]; });
+        return r;
+    }
+
+    friend constexpr dual operator/(dual const& a, dual const& b)
+    {
+        T const inverse = 1 / b.value;
+        dual r;
+        r.value = a.value * inverse;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = (a.d[i] - r.value * b.d[i]) * inverse; });
+        return r;
+    }
+
+    // mixed operations with constants skip the products with zero derivatives
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator+(dual const& a, S const s)
+    {
+        return dual(a.value + s, a.d);
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator+(S const s, dual const& a)
+    {
+        return dual(s + a.value, a.d);
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator-(dual const& a, S const s)
+    {
+        return dual(a.value - s, a.d);
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator-(S const s, dual const& a)
+    {
+        dual r = -a;
+        r.value = s - a.value;
+        return r;
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator*(dual const& a, S const s)
+    {
+        dual r;
+        r.value = a.value * s;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = a.d[i] * s; });
+        return r;
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator*(S const s, dual const& a)
+    {
+        return a * s;
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator/(dual const& a, S const s)
+    {
+        dual r;
+        r.value = a.value / s;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = a.d[i] / s; });
+        return r;
+    }
+
+    template<typename S> requires std::is_arithmetic_v<S>
+    friend constexpr dual operator/(S const s, dual const& a)
+    {
+        T const inverse = 1 / a.value;
+        dual r;
+        r.value = s * inverse;
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = -r.value * a.d[i] * inverse; });
+        return r;
+    }
+
+    constexpr dual& operator+=(dual const& b) { return *this = *this + b; }
+    constexpr dual& operator-=(dual const& b) { return *this = *this - b; }
+    constexpr dual& operator*=(dual const& b) { return *this = *this * b; }
+    constexpr dual& operator/=(dual const& b) { return *this = *this / b; }
+
+    // comparisons order by value only, as the selects in sgn need
+    friend constexpr bool operator==(dual const& a, dual const& b) { return a.value == b.value; }
+    friend constexpr auto operator<=>(dual const& a, dual const& b) { return a.value <=> b.value; }
+};
+
+/**
+ * Sign of the value with zero derivatives, found by argument-dependent lookup
+ * in place of the generic sgn, whose selects between whole duals would leave
+ * a branch in the batch loops
+ */
+template<typename T, std::size_t N>
+constexpr dual<T, N> sgn(dual<T, N> const& a)
+{
+    using sphc::sgn;
+    return dual<T, N>(sgn(a.value), {});
+}
+
+namespace
+{
+
+// f(a) from f(a.value) and f'(a.value) by the chain rule
+template<typename T, std::size_t N>
+constexpr dual<T, N> chain(dual<T, N> const& a, T const& f, T const& df)
+{
+    dual<T, N> r;
+    r.value = f;
+    for_each_derivative<N>([&](std::size_t const i) { r.d[i] = df * a.d[i]; });
+    return r;
+}
+
+}
+
+/**
+ * Math policy for dual numbers
+ *
+ * Plain arguments forward to Math; dual arguments evaluate the value and its
+ * derivative with the same policy and apply the chain rule, recursively for
+ * nested duals.
+ */
+template<typename Math = std_math>
+struct dual_math
+{
+    template<typename Float> static Float sin(Float x) { return Math::sin(x); }
+    template<typename Float> static Float cos(Float x) { return Math::cos(x); }
+    template<typename Float> static void sincos(Float x, Float& s, Float& c) { Math::sincos(x, s, c); }
+    template<typename Float> static Float exp(Float x) { return Math::exp(x); }
+    template<typename Float> static Float tanh(Float x) { return Math::tanh(x); }
+    template<typename Float> static Float atan(Float x) { return Math::atan(x); }
+    template<typename Float> static Float atan2(Float y, Float x) { return Math::atan2(y, x); }
+    template<typename Float> static Float acos(Float x) { return Math::acos(x); }
+    template<typename Float> static Float sqrt(Float x) { return Math::sqrt(x); }
+    template<typename Float> static Float abs(Float x) { return Math::abs(x); }
+
+    template<typename T, std::size_t N>
+    static void sincos(dual<T, N> const& x, dual<T, N>& s, dual<T, N>& c)
+    {
+        T sv, cv;
+        sincos(x.value, sv, cv);
+        s = chain(x, sv, cv);
+        c = chain(x, cv, -sv);
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> sin(dual<T, N> const& x)
+    {
+        dual<T, N> s, c;
+        sincos(x, s, c);
+        return s;
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> cos(dual<T, N> const& x)
+    {
+        dual<T, N> s, c;
+        sincos(x, s, c);
+        return c;
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> exp(dual<T, N> const& x)
+    {
+        T const e = exp(x.value);
+        return chain(x, e, e);
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> tanh(dual<T, N> const& x)
+    {
+        T const t = tanh(x.value);
+        return chain(x, t, 1 - t * t);
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> atan(dual<T, N> const& x)
+    {
+        return chain(x, atan(x.value), 1 / (1 + x.value * x.value));
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> atan2(dual<T, N> const& y, dual<T, N> const& x)
+    {
+        T const inverse = 1 / (x.value * x.value + y.value * y.value);
+        dual<T, N> r;
+        r.value = atan2(y.value, x.value);
+        for_each_derivative<N>([&](std::size_t const i) { r.d[i] = (x.value * y.d[i] - y.value * x.d[i]) * inverse; });
+        return r;
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> acos(dual<T, N> const& x)
+    {
+        return chain(x, acos(x.value), -1 / sqrt(1 - x.value * x.value));
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> sqrt(dual<T, N> const& x)
+    {
+        T const s = sqrt(x.value);
+        return chain(x, s, 0.5f / s);
+    }
+
+    template<typename T, std::size_t N>
+    static dual<T, N> abs(dual<T, N> const& x)
+    {
+        return chain(x, abs(x.value), x.value < T(0) ? T(-1) : T(1));
+    }
+};
+
+template<typename Float>
+using gradient_dual = dual<Float, 3>;
+
+template<typename Float>
+using hessian_dual = dual<dual<Float, 3>, 3>;
+
+/**
+ * Value and derivatives on the sphere at a unit vector
+ */
+template<typename Float>
+struct derivatives
+{
+    Float value;
+    std::array<Float, 3> gradient;      // surface gradient, tangent at the point
+    std::array<Float, 6> hessian;       // surface Hessian xx, xy, xz, yy, yz, zz; zero unless requested
+};
+
+/**
+ * Scalar signature: unit vector to value and surface gradient
+ */
+template<typename Float>
+using gradient_function = void (*)(Float, Float, Float, Float&, Float&, Float&, Float&);
+
+/**
+ * Scalar signature: unit vector to value, surface gradient and Hessian
+ */
+template<typename Float>
+using hessian_function = derivatives<Float> (*)(Float, Float, Float);
+
+/**
+ * Batch signature: structure-of-arrays unit vectors to values and surface
+ * gradients
+ */
+template<typename Float>
+using batch_gradient_function = void (*)(std::span<Float const>, std::span<Float const>, std::span<Float const>,
+    std::span<Float>, std::span<Float>, std::span<Float>, std::span<Float>);
+
+/**
+ * Value and surface gradient of a function template instantiated with duals
+ */
+template<typename Float, gradient_dual<Float> (*Fn)(gradient_dual<Float>, gradient_dual<Float>, gradient_dual<Float>)>
+void value_and_gradient(Float const x, Float const y, Float const z, Float& value, Float& gx, Float& gy, Float& gz)
+{
+    using D = gradient_dual<Float>;
+    D const r = Fn(D(x, { 1, 0, 0 }), D(y, { 0, 1, 0 }), D(z, { 0, 0, 1 }));
+
+    Float const radial = r.d[0] * x + r.d[1] * y + r.d[2] * z;
+    value = r.value;
+    gx = r.d[0] - radial * x;
+    gy = r.d[1] - radial * y;
+    gz = r.d[2] - radial * z;
+}
+
+/**
+ * Value, surface gradient and surface Hessian of a function template
+ * instantiated with nested duals
+ */
+template<typename Float, hessian_dual<Float> (*Fn)(hessian_dual<Float>, hessian_dual<Float>, hessian_dual<Float>)>
+derivatives<Float> value_gradient_hessian(Float const x, Float const y, Float const z)
+{
+    using D = gradient_dual<Float>;
+    using H = hessian_dual<Float>;
+    auto seed = [](Float const v, std::size_t const k)
+    {
+        H h(D(v, {}), {});
+        h.value.d[k] = 1;
+        h.d[k] = D(1);
+        return h;
+    };
+    H const r = Fn(seed(x, 0), seed(y, 1), seed(z, 2));
+
+    std::array<Float, 3> const p = { x, y, z };
+    Float const radial = r.value.d[0] * x + r.value.d[1] * y + r.value.d[2] * z;
+
+    derivatives<Float> out{};
+    out.value = r.value.value;
+    for (std::size_t i = 0; i < 3; ++i)
+        out.gradient[i] = r.value.d[i] - radial * p[i];
+
+    // P H P - (g . p) P, with (H P)_ij = H_ij - (H p)_i p_j
+    std::array<Float, 3> hp{};
+    for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+            hp[i] += r.d[i].d[j] * p[j];
+    Float const php = hp[0] * x + hp[1] * y + hp[2] * z;
+
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = i; j < 3; ++j)
+        {
+            Float const projector = (i == j ? 1 : 0) - p[i] * p[j];
+            out.hessian[k++] = r.d[i].d[j] - hp[i] * p[j] - p[i] * hp[j] + php * p[i] * p[j] - radial * projector;
+        }
+    }
+    return out;
+}
+
+/**
+ * All differentiated entry points of a single function
+ */
+template<typename Float>
+struct autodiff_entry
+{
+    gradient_function<Float> gradient;
+    hessian_function<Float> hessian;
+    batch_gradient_function<Float> batch_gradient;
+};
+
+#define SPHC_AUTODIFF_ENTRY(family, name)                                                                   \
+    { &value_and_gradient<Float, &sphc::family::name<gradient_dual<Float>, dual_math<std_math>>>,          \
+      &value_gradient_hessian<Float, &sphc::family::name<hessian_dual<Float>, dual_math<std_math>>>,       \
+      &eval_batch_xyz4_simd<Float,                                                                          \
+          &value_and_gradient<Float, &sphc::family::name<gradient_dual<Float>, dual_math<BatchMath>>>> }
+
+/**
+ * Compile-time table of the differentiated functions indexed by FunctionId
+ *
+ * The batch entries use BatchMath for the values and derivatives of the
+ * elementary functions, like function_table.
+ */
+template<typename Float, typename BatchMath = batch_math<Float>>
+inline constexpr std::array<autodiff_entry<Float>, function_count> autodiff_table =
+{{
+    SPHC_AUTODIFF_ENTRY(polynomial, p1),
+    SPHC_AUTODIFF_ENTRY(discontinuous, d1),
+    SPHC_AUTODIFF_ENTRY(discontinuous, d2),
+    SPHC_AUTODIFF_ENTRY(discontinuous, d3),
+    SPHC_AUTODIFF_ENTRY(discontinuous, d4),
+    SPHC_AUTODIFF_ENTRY(smooth_approx, s1),
+    SPHC_AUTODIFF_ENTRY(smooth_approx, s2),
+    SPHC_AUTODIFF_ENTRY(smooth_approx, s3),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o1),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o2),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o3),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o4),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o5),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o6),
+    SPHC_AUTODIFF_ENTRY(oscillatory, o7),
+    SPHC_AUTODIFF_ENTRY(lobes, l1),
+    SPHC_AUTODIFF_ENTRY(lobes, l2),
+    SPHC_AUTODIFF_ENTRY(lobes, l3),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a1),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a2),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a3),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a4),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a5),
+    SPHC_AUTODIFF_ENTRY(absolute_values, a6),
+    SPHC_AUTODIFF_ENTRY(zsymnetric, z1),
+    SPHC_AUTODIFF_ENTRY(zsymnetric, z2),
+    SPHC_AUTODIFF_ENTRY(zsymnetric, z3)
+}};
+
+#undef SPHC_AUTODIFF_ENTRY
+
+/**
+ * Get a scalar value and gradient evaluator by its identifier
+ */
+template<typename Float>
+constexpr gradient_function<Float> get_gradient_function(FunctionId const id)
+{
+    return autodiff_table<Float>[static_cast<std::size_t>(id)].gradient;
+}
+
+template<typename Float>
+constexpr gradient_function<Float> get_gradient_function(std::string_view const id)
+{
+    return get_gradient_function<Float>(function_id(id));
+}
+
+/**
+ * Get a batch value and gradient evaluator by its identifier
+ *
+ * @tparam Math Math policy of the kernel, e.g. fast_math
+ */
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_gradient_function<Float> get_batch_gradient_function(FunctionId const id)
+{
+    return autodiff_table<Float, Math>[static_cast<std::size_t>(id)].batch_gradient;
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_gradient_function<Float> get_batch_gradient_function(std::string_view const id)
+{
+    return get_batch_gradient_function<Float, Math>(function_id(id));
+}
+
+/**
+ * Evaluate a function and its surface gradient over contiguous arrays of unit
+ * vectors in one pass
+ *
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
+ * @param x, y, z Unit vector components, all of the same size
+ * @param value Output values, at least as large as x
+ * @param gx, gy, gz Output surface gradients, each at least as large as x
+ */
+template<typename Float, typename Math = batch_math<Float>>
+void eval_with_gradient(FunctionId const id, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> value, std::span<Float> gx, std::span<Float> gy, std::span<Float> gz)
+{
+    get_batch_gradient_function<Float, Math>(id)(x, y, z, value, gx, gy, gz);
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+void eval_with_gradient(std::string_view const id, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> value, std::span<Float> gx, std::span<Float> gy, std::span<Float> gz)
+{
+    get_batch_gradient_function<Float, Math>(id)(x, y, z, value, gx, gy, gz);
+}
+
+/**
+ * Value and surface derivatives of a function at a unit vector
+ *
+ * @param id The identifier of the function
+ * @param x, y, z Unit vector
+ * @param hessian Also compute the surface Hessian, at about four times the cost
+ * @return The value, gradient and, if requested, Hessian
+ */
+template<typename Float>
+derivatives<Float> differentiate(FunctionId const id, Float const x, Float const y, Float const z,
+    bool const hessian = false)
+{
+    if (hessian)
+        return autodiff_table<Float>[static_cast<std::size_t>(id)].hessian(x, y, z);
+
+    derivatives<Float> out{};
+    get_gradient_function<Float>(id)(x, y, z, out.value, out.gradient[0], out.gradient[1], out.gradient[2]);
+    return out;
+}
+
+template<typename Float>
+derivatives<Float> differentiate(std::string_view const id, Float const x, Float const y, Float const z,
+    bool const hessian = false)
+{
+    return differentiate<Float>(function_id(id), x, y, z, hessian);
+}
+
+} // namespace autodiff
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_AUTODIFF_H
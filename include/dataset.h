@@ -0,0 +1,402 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_DATASET_H
+#define SPHERICAL_COLLECTION_DATASET_H
+
+#include <span>
+#include <cerrno>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "functions.h"
+#include "parallel.h"
+
+namespace sphc
+{
+
+/**
+ * Memory-mapped binary files of point sets and function values
+ *
+ * A file is a 64-byte header followed by one column per coordinate and, when
+ * the file records a function, a column of its values. Columns hold count
+ * values of the file's precision and start on 64-byte boundaries, so mapped
+ * columns can be passed directly to the batch evaluators. The function is
+ * stored by name, which keeps files valid across reorderings of the registry.
+ * Values are in native byte order; a byte order mark rejects foreign files.
+ */
+namespace dataset
+{
+
+enum class coordinates : std::uint32_t
+{
+    spherical,          // theta, phi
+    cartesian           // x, y, z
+};
+
+inline constexpr std::uint32_t format_version = 1;
+
+struct header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t precision;            // bytes per value
+    std::uint32_t coordinates;
+    std::uint32_t columns;              // coordinate columns plus the values column
+    std::uint32_t reserved;
+    std::uint64_t count;                // points
+    std::uint64_t stride;               // values per column, count rounded up to 64 bytes
+    char function[16];                  // name of the function of the values column, empty for points only
+};
+
+static_assert(sizeof(header) == 64 && std::is_trivially_copyable_v<header>);
+
+namespace
+{
+
+inline constexpr char dataset_magic[8] = { 'S', 'P', 'H', 'C', 'D', 'A', 'T', 'A' };
+inline constexpr std::uint32_t dataset_byte_order = 0x01020304;
+
+inline std::size_t coordinate_columns(coordinates const c)
+{
+    return c == coordinates::spherical ? 2 : 3;
+}
+
+[[noreturn]] inline void throw_system_error(std::string const& what)
+{
+#if defined(_WIN32)
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+    throw std::system_error(errno, std::generic_category(), what);
+#endif
+}
+
+} // namespace
+
+/**
+ * Mapping of a dataset file, move-only; the mapping is released on
+ * destruction
+ */
+template<typename Float>
+class file
+{
+    static_assert(std::is_same_v<Float, float> || std::is_same_v<Float, double>,
+        "datasets hold float or double values");
+
+public:
+    file() = default;
+    file(file const&) = delete;
+    file& operator=(file const&) = delete;
+
+    file(file&& other) noexcept
+        : base(std::exchange(other.base, nullptr)), length(std::exchange(other.length, 0)),
+          writable(other.writable)
+    {
+    }
+
+    file& operator=(file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            base = std::exchange(other.base, nullptr);
+            length = std::exchange(other.length, 0);
+            writable = other.writable;
+        }
+        return *this;
+    }
+
+    ~file()
+    {
+        release();
+    }
+
+    header const& info() const { return *reinterpret_cast<header const*>(base); }
+    std::size_t size() const { return static_cast<std::size_t>(info().count); }
+    dataset::coordinates layout() const { return static_cast<dataset::coordinates>(info().coordinates); }
+    bool is_writable() const { return writable; }
+
+    /**
+     * The function of the values column, if the file has one
+     */
+    std::optional<FunctionId> function() const
+    {
+        header const& h = info();
+        std::string_view const name(h.function,
+            static_cast<std::size_t>(std::find(h.function, h.function + sizeof(h.function), '\0') - h.function));
+        if (name.empty())
+            return std::nullopt;
+        return function_id(name);
+    }
+
+    /**
+     * Column k in file order: theta, phi or x, y, z, then the values
+     */
+    std::span<Float const> column(std::size_t const k) const
+    {
+        if (k >= info().columns)
+            throw std::out_of_range("no such dataset column");
+        return { data() + k * info().stride, size() };
+    }
+
+    /**
+     * Writable column k
+     *
+     * @throws std::logic_error if the file is mapped read-only
+     */
+    std::span<Float> mutable_column(std::size_t const k)
+    {
+        if (!writable)
+            throw std::logic_error("dataset is mapped read-only");
+        if (k >= info().columns)
+            throw std::out_of_range("no such dataset column");
+        return { data() + k * info().stride, size() };
+    }
+
+    std::span<Float const> values() const { return column(coordinate_columns(layout())); }
+    std::span<Float> mutable_values() { return mutable_column(coordinate_columns(layout())); }
+
+    /**
+     * Flush written pages to the file
+     */
+    void sync()
+    {
+        if (!writable || base == nullptr)
+            return;
+#if defined(_WIN32)
+        if (!FlushViewOfFile(base, length))
+#else
+        if (msync(base, length, MS_SYNC) != 0)
+#endif
+            throw_system_error("cannot flush dataset");
+    }
+
+private:
+    template<typename T>
+    friend file<T> create(std::string const&, coordinates, std::size_t, std::optional<FunctionId>);
+
+    template<typename T>
+    friend file<T> open(std::string const&, bool);
+
+    void* base = nullptr;
+    std::size_t length = 0;
+    bool writable = false;
+
+    Float* data() const
+    {
+        return reinterpret_cast<Float*>(static_cast<char*>(base) + sizeof(header));
+    }
+
+    void map(std::string const& path, bool const create, std::size_t const bytes)
+    {
+#if defined(_WIN32)
+        HANDLE const handle = CreateFileA(path.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0),
+            FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            throw_system_error("cannot open " + path);
+
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(bytes);
+        if (!create && !GetFileSizeEx(handle, &size))
+        {
+            CloseHandle(handle);
+            throw_system_error("cannot stat " + path);
+        }
+        length = static_cast<std::size_t>(size.QuadPart);
+
+        HANDLE const mapping = length == 0 ? nullptr : CreateFileMappingA(handle, nullptr,
+            writable ? PAGE_READWRITE : PAGE_READONLY, size.HighPart, size.LowPart, nullptr);
+        CloseHandle(handle);
+        if (mapping == nullptr)
+            throw_system_error("cannot map " + path);
+        base = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length);
+        CloseHandle(mapping);
+        if (base == nullptr)
+            throw_system_error("cannot map " + path);
+#else
+        int const fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | (create ? O_CREAT | O_TRUNC : 0), 0644);
+        if (fd < 0)
+            throw_system_error("cannot open " + path);
+
+        struct stat st;
+        if (create ? ftruncate(fd, static_cast<off_t>(bytes)) != 0 : fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw_system_error("cannot size " + path);
+        }
+        length = create ? bytes : static_cast<std::size_t>(st.st_size);
+
+        void* const p = length == 0 ? MAP_FAILED :
+            mmap(nullptr, length, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw_system_error("cannot map " + path);
+        base = p;
+#endif
+    }
+
+    void release() noexcept
+    {
+        if (base == nullptr)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(base);
+#else
+        munmap(base, length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+};
+
+/**
+ * Create a dataset file of the given size and map it for writing
+ *
+ * The columns are zero-filled. A function adds a values column, which
+ * evaluate fills from the coordinates.
+ *
+ * @param path File to create or truncate
+ * @param layout Coordinates of the points
+ * @param count Number of points
+ * @param id Function of the values column, none for a point set only
+ * @return Writable mapping
+ * @throws std::system_error if the file cannot be created or mapped
+ */
+template<typename Float>
+file<Float> create(std::string const& path, coordinates const layout, std::size_t const count,
+    std::optional<FunctionId> const id = std::nullopt)
+{
+    std::size_t constexpr per_line = 64 / sizeof(Float);
+    std::size_t const stride = (count + per_line - 1) / per_line * per_line;
+    std::size_t const columns = coordinate_columns(layout) + (id ? 1 : 0);
+
+    file<Float> f;
+    f.writable = true;
+    f.map(path, true, sizeof(header) + columns * stride * sizeof(Float));
+
+    header h{};
+    std::memcpy(h.magic, dataset_magic, sizeof(h.magic));
+    h.version = format_version;
+    h.byte_order = dataset_byte_order;
+    h.precision = sizeof(Float);
+    h.coordinates = static_cast<std::uint32_t>(layout);
+    h.columns = static_cast<std::uint32_t>(columns);
+    h.count = count;
+    h.stride = stride;
+    if (id)
+    {
+        std::string_view const name = function_name(*id);
+        std::memcpy(h.function, name.data(), std::min(name.size(), sizeof(h.function)));
+    }
+    std::memcpy(f.base, &h, sizeof(h));
+    return f;
+}
+
+/**
+ * Map an existing dataset file
+ *
+ * @param path File to map
+ * @param writable Map for writing, so that evaluate can fill the values in place
+ * @return Mapping
+ * @throws std::system_error if the file cannot be opened or mapped
+ * @throws std::runtime_error if the file is not a dataset of this version,
+ *         byte order and precision, or is shorter than its header declares
+ */
+template<typename Float>
+file<Float> open(std::string const& path, bool const writable = false)
+{
+    file<Float> f;
+    f.writable = writable;
+    f.map(path, false, 0);
+
+    if (f.length < sizeof(header))
+        throw std::runtime_error("not a dataset: " + path);
+    header const& h = f.info();
+    if (std::memcmp(h.magic, dataset_magic, sizeof(h.magic)) != 0)
+        throw std::runtime_error("not a dataset: " + path);
+    if (h.version > format_version)
+        throw std::runtime_error("unsupported dataset version: " + path);
+    if (h.byte_order != dataset_byte_order)
+        throw std::runtime_error("dataset has a foreign byte order: " + path);
+    if (h.precision != sizeof(Float))
+        throw std::runtime_error("dataset has a different floating point type: " + path);
+    // the length is divided rather than the stride multiplied, so a huge stride cannot wrap
+    if (h.coordinates > static_cast<std::uint32_t>(coordinates::cartesian) || h.stride < h.count ||
+        h.columns < coordinate_columns(f.layout()) || h.columns > coordinate_columns(f.layout()) + 1 ||
+        h.stride > (f.length - sizeof(header)) / sizeof(Float) / h.columns)
+        throw std::runtime_error("corrupt dataset header: " + path);
+    if (h.columns > coordinate_columns(f.layout()) && !f.function())
+        throw std::runtime_error("dataset values without a function: " + path);
+    return f;
+}
+
+/**
+ * Fill the values column of a file from its coordinates with the dispatched
+ * SIMD kernel of its function, in parallel
+ *
+ * @param f Writable mapping of a file with a function
+ * @param threads Worker threads, 0 for hardware concurrency
+ * @throws std::logic_error if the file is read-only or records no function
+ */
+template<typename Float>
+void evaluate(file<Float>& f, unsigned const threads = 0)
+{
+    std::optional<FunctionId> const id = f.function();
+    if (!id)
+        throw std::logic_error("dataset records no function");
+
+    std::span<Float> const out = f.mutable_values();
+    std::size_t constexpr chunk = 1 << 14;
+    std::size_t const chunks = (f.size() + chunk - 1) / chunk;
+
+    if (f.layout() == coordinates::spherical)
+    {
+        batch_function<Float> const fn = get_batch_function<Float>(*id);
+        parallel_for(chunks, threads, false, [&](std::size_t const c, unsigned)
+        {
+            std::size_t const first = c * chunk, count = std::min(chunk, f.size() - first);
+            fn(f.column(0).subspan(first, count), f.column(1).subspan(first, count), out.subspan(first, count));
+        });
+    }
+    else
+    {
+        batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(*id);
+        parallel_for(chunks, threads, false, [&](std::size_t const c, unsigned)
+        {
+            std::size_t const first = c * chunk, count = std::min(chunk, f.size() - first);
+            fn(f.column(0).subspan(first, count), f.column(1).subspan(first, count),
+                f.column(2).subspan(first, count), out.subspan(first, count));
+        });
+    }
+}
+
+} // namespace dataset
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_DATASET_H
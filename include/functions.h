@@ -7,10 +7,21 @@
 #ifndef SPHERICAL_COLLECTION_FUNCTIONS_H
 #define SPHERICAL_COLLECTION_FUNCTIONS_H
 
+#include <array>
 #include <tuple>
+#include <span>
 #include <cmath>
-#include <functional>
-#include <unordered_map>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <numbers>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include "simd.h"
+#include "vmath.h"
 
 namespace sphc
 {
@@ -26,19 +37,34 @@ namespace sphc
 namespace
 {
 
-template<typename Float>
+template<typename Float, typename Math = std_math>
 std::tuple<Float, Float, Float> spherical_to_xyz(Float const& theta, Float const& phi)
 {
-    Float x = std::sin(theta) * std::cos(phi);
-    Float y = std::sin(theta) * std::sin(phi);
-    Float z = std::cos(theta);
-    return { x, y, z };
+    Float sin_theta, cos_theta, sin_phi, cos_phi;
+    Math::sincos(theta, sin_theta, cos_theta);
+    Math::sincos(phi, sin_phi, cos_phi);
+    return { sin_theta * cos_phi, sin_theta * sin_phi, cos_theta };
+}
+
+template<typename Float, typename Math = std_math>
+std::tuple<Float, Float> xyz_to_spherical(Float const& x, Float const& y, Float const& z)
+{
+    Float theta = Math::atan2(Math::sqrt(x * x + y * y), z);
+    Float phi = Math::atan2(y, x);
+    return { theta, phi };
 }
 
+// sign with sgn(0) == 0, as compare-and-select masks so it stays branchless
+// and in floating point inside vectorized loops; conditional expressions of
+// constants are turned back into branches, so float and double use the
+// bitwise vmath select
 template <typename T>
-int sgn(T val)
+T sgn(T val)
 {
-    return (T(0) < val) - (val < T(0));
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        return vmath::select(T(0) < val, T(1), vmath::select(val < T(0), T(-1), T(0)));
+    else
+        return (T(0) < val ? T(1) : T(0)) - (val < T(0) ? T(1) : T(0));
 }
 
 template<typename Float>
@@ -58,13 +84,19 @@ namespace polynomial
 
 // From: "On spherical harmonics based numerical quadrature over the surface of a sphere"
 // fornberg_f1
-template<typename Float>
-Float p1(Float const theta, Float const phi)
+template<typename Float, typename Math = std_math>
+Float p1(Float const x, Float const y, Float const z)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
     return 1.0f + x + y * y + x * x * y + x * x * x * x + y * y * y * y * y + x * x * y * y * z * z;
 }
 
+template<typename Float, typename Math = std_math>
+Float p1(Float const theta, Float const phi)
+{
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return p1<Float, Math>(x, y, z);
+}
+
 } // namespace polynomial
 
 namespace discontinuous
@@ -72,38 +104,62 @@ namespace discontinuous
 
 // From: "On spherical harmonics based numerical quadrature over the surface of a sphere"
 // fornberg_f4
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float d1(Float const x, Float const y, Float const z)
+{
+    return (1.0f + sgn(-9.0f * x - 9.0f * y + 9.0f * z)) / 9.0f;
+}
+
+template<typename Float, typename Math = std_math>
 Float d1(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (1.0f + (Float)sgn(-9.0f * x - 9.0f * y + 9.0f * z)) / 9.0f;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return d1<Float, Math>(x, y, z);
 }
 
 // beentjes_f4
-template<typename Float>
-Float d2(Float const theta, Float const phi)
+template<typename Float, typename Math = std_math>
+Float d2(Float const x, Float const y, Float const z)
 {
     Float constexpr alpha = 9.0f;
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (1.0f - (Float)sgn(x + y - z)) / alpha;
+    return (1.0f - sgn(x + y - z)) / alpha;
+}
+
+template<typename Float, typename Math = std_math>
+Float d2(Float const theta, Float const phi)
+{
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return d2<Float, Math>(x, y, z);
 }
 
 // beentjes_f5
-template<typename Float>
-Float d3(Float const theta, Float const phi)
+template<typename Float, typename Math = std_math>
+Float d3(Float const x, Float const y, Float const /*z*/)
 {
     Float constexpr alpha = 9.0f;
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (1.0f - (Float)sgn(F_PI * x + y)) / alpha;
+    return (1.0f - sgn(F_PI * x + y)) / alpha;
+}
+
+template<typename Float, typename Math = std_math>
+Float d3(Float const theta, Float const phi)
+{
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return d3<Float, Math>(x, y, z);
 }
 
 // 10. From: "Spherical Harmonics Collocation: A Computational Intercomparison of Several Grids"
 // bellet_f4
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float d4(Float const x, Float const /*y*/, Float const /*z*/)
+{
+    return 0.5f * (1.0f + sgn(x - 0.5f));
+}
+
+template<typename Float, typename Math = std_math>
 Float d4(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return 0.5f * (1.0f + (Float)sgn(x - 0.5f));
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return d4<Float, Math>(x, y, z);
 }
 
 } // namespace discontinuous
@@ -112,30 +168,48 @@ namespace smooth_approx
 {
 
 // beentjes_f3
-template<typename Float>
-Float s1(Float const theta, Float const phi)
+template<typename Float, typename Math = std_math>
+Float s1(Float const x, Float const y, Float const z)
 {
     Float constexpr alpha = 9.0f;
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (1.0f + std::tanh(-alpha * x - alpha * y + alpha * z)) / alpha;
+    return (1.0f + Math::tanh(-alpha * x - alpha * y + alpha * z)) / alpha;
+}
+
+template<typename Float, typename Math = std_math>
+Float s1(Float const theta, Float const phi)
+{
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return s1<Float, Math>(x, y, z);
 }
 
 // 9. From: "Numerical Quadrature over the Surface of a Sphere"
 // reegar_f3
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float s2(Float const /*x*/, Float const /*y*/, Float const z)
+{
+    return (F_PI_2 + Math::atan(300.0f * (z - 9999.0f / 10000.0f))) / F_PI;
+}
+
+template<typename Float, typename Math = std_math>
 Float s2(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (F_PI_2 + std::atan(300.0f * (z - 9999.0f / 10000.0f))) / F_PI;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return s2<Float, Math>(x, y, z);
 }
 
 // 12. From: "Numerical quadrature over smooth surfaces with boundaries"
 // reegar_f4
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float s3(Float const /*x*/, Float const /*y*/, Float const z)
+{
+    return 0.5f + Math::atan(1000.0f * (z - 9999.0f / (10000.0f * 2.0f * std::sqrt(2)))) / F_PI;
+}
+
+template<typename Float, typename Math = std_math>
 Float s3(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return 0.5f + std::atan(1000.0f * (z - 9999.0f / (10000.0f * 2.0f * std::sqrt(2)))) / F_PI;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return s3<Float, Math>(x, y, z);
 }
 
 } // namespace smooth_approx
@@ -144,58 +218,111 @@ namespace oscillatory
 {
 
 // 6. renka_f3
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float o1(Float const x, Float const y, Float const z)
+{
+    return (1.25f + Math::cos(5.4f * y)) * Math::cos(6.0f * z) / (6.0f + 6.0f * (3.0f * x - 1) * (3.0f * x - 1));
+}
+
+template<typename Float, typename Math = std_math>
 Float o1(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (1.25f + std::cos(5.4f * y)) * std::cos(6.0f * z) / (6.0f + 6.0f * (3.0f * x - 1) * (3.0f * x - 1));
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return o1<Float, Math>(x, y, z);
 }
 
 // 23. cf_f10
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float o2(Float const x, Float const y, Float const z)
+{
+    return x * x + y * y + z * z + 5 + 2.5f * Math::cos((Math::acos(z) - F_PI) / 2.0f) * Math::sin(16.0f * Math::acos(z));
+}
+
+template<typename Float, typename Math = std_math>
 Float o2(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return x * x + y * y + z * z + 5 + 2.5f * std::cos((std::acos(z) - F_PI) / 2.0f) * std::sin(16.0f * std::acos(z));
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return o2<Float, Math>(x, y, z);
 }
 
 // 25. cf_f12
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float o3(Float const x, Float const y, Float const z)
+{
+    return Math::sin(10.0f * x) + Math::cos(12.0f * y) - Math::sin(15.0f * z) + 0.2f * Math::cos(18.0f * x) + 3.0f;
+}
+
+template<typename Float, typename Math = std_math>
 Float o3(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::sin(10.0f * x) + std::cos(12.0f * y) - std::sin(15.0f * z) + 0.2f * std::cos(18.0f * x) + 3.0f;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return o3<Float, Math>(x, y, z);
 }
 
 // 26. cf_f13
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float o4(Float const x, Float const y, Float const z)
+{
+    return Math::exp(-Math::sin(5.0f * x) - Math::cos(6.0f * y)) + 0.3f * Math::sin(10.0f * z);
+}
+
+template<typename Float, typename Math = std_math>
 Float o4(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::exp(-std::sin(5.0f * x) - std::cos(6.0f * y)) + 0.3f * std::sin(10.0f * z);
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return o4<Float, Math>(x, y, z);
 }
 
 // 17. cf_f4
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float o5(Float const theta, Float const phi)
 {
-    return 1.0f + std::cos(5.0f * phi) / 5.0f + std::sin(5.0f * theta);
+    return 1.0f + Math::cos(5.0f * phi) / 5.0f + Math::sin(5.0f * theta);
+}
+
+template<typename Float, typename Math = std_math>
+Float o5(Float const x, Float const y, Float const z)
+{
+    auto [theta, phi] = xyz_to_spherical<Float, Math>(x, y, z);
+    return o5<Float, Math>(theta, phi);
 }
 
 // 18. cf_f5
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float o6(Float const theta, Float const phi)
 {
-    return 1.5f * std::exp(0.8f * (std::sin(theta) * std::cos(phi) + 0.5f * std::cos(theta))) +
-           1.2f * std::exp(0.6f * (-std::sin(theta) * std::sin(phi) + 0.3f * std::cos(theta))) +
-           0.8f * std::exp(0.5f * std::cos(theta)) + 0.5f * (1.0f + std::cos(6.0f * theta) * std::sin(4.0f * phi));
+    Float sin_theta, cos_theta, sin_phi, cos_phi;
+    Math::sincos(theta, sin_theta, cos_theta);
+    Math::sincos(phi, sin_phi, cos_phi);
+
+    // cos(6 theta) and sin(4 phi) by the double and triple angle identities
+    Float const cos_2theta = cos_theta * cos_theta - sin_theta * sin_theta;
+    Float const cos_6theta = cos_2theta * (4.0f * cos_2theta * cos_2theta - 3.0f);
+    Float const sin_4phi = 4.0f * sin_phi * cos_phi * (cos_phi * cos_phi - sin_phi * sin_phi);
+
+    return 1.5f * Math::exp(0.8f * (sin_theta * cos_phi + 0.5f * cos_theta)) +
+           1.2f * Math::exp(0.6f * (-sin_theta * sin_phi + 0.3f * cos_theta)) +
+           0.8f * Math::exp(0.5f * cos_theta) + 0.5f * (1.0f + cos_6theta * sin_4phi);
+}
+
+template<typename Float, typename Math = std_math>
+Float o6(Float const x, Float const y, Float const z)
+{
+    auto [theta, phi] = xyz_to_spherical<Float, Math>(x, y, z);
+    return o6<Float, Math>(theta, phi);
 }
 
 // 19. cf_f6
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float o7(Float const theta, Float const phi)
 {
-    return 1.0f + 0.5f * std::cos(theta) + 0.3f * std::cos(2.0f * phi);
+    return 1.0f + 0.5f * Math::cos(theta) + 0.3f * Math::cos(2.0f * phi);
+}
+
+template<typename Float, typename Math = std_math>
+Float o7(Float const x, Float const y, Float const z)
+{
+    return 1.0f + 0.5f * z + 0.3f * Math::cos(2.0f * Math::atan2(y, x));
 }
 
 } // namespace oscillatory
@@ -203,42 +330,108 @@ Float o7(Float const theta, Float const phi)
 namespace lobes
 {
 
-// 7. renka_f4
+/**
+ * Isotropic Gaussian lobe amplitude * exp(-sharpness * |p - center|^2)
+ */
 template<typename Float>
+struct gaussian_lobe
+{
+    Float x, y, z;              // center
+    Float sharpness;
+    Float amplitude;
+};
+
+/**
+ * Sum of Gaussian lobes at a point, all lobes in one pass
+ *
+ * The squared distance to each center is a plain dot product of the offset,
+ * so the sum vectorizes like any other function of the collection. A new lobe
+ * test function is a constexpr array of lobes and a function template that
+ * calls this, e.g. for eval_batch_xyz_simd.
+ *
+ * @param lobes Lobe parameters
+ * @param x, y, z Point
+ * @return Sum of the lobes
+ */
+template<typename Float, typename Math = std_math, std::size_t N>
+Float gaussian_lobes(std::array<gaussian_lobe<Float>, N> const& lobes, Float const x, Float const y, Float const z)
+{
+    Float sum = 0.0f;
+    for (gaussian_lobe<Float> const& lobe : lobes)
+    {
+        Float const dx = x - lobe.x;
+        Float const dy = y - lobe.y;
+        Float const dz = z - lobe.z;
+        sum += lobe.amplitude * Math::exp(-lobe.sharpness * (dx * dx + dy * dy + dz * dz));
+    }
+    return sum;
+}
+
+template<typename Float>
+inline constexpr std::array<gaussian_lobe<Float>, 1> l1_lobes =
+{{
+    { 0.5f, 0.5f, 0.5f, 81.0f / 16.0f, Float(1) / 3 }
+}};
+
+template<typename Float>
+inline constexpr std::array<gaussian_lobe<Float>, 1> l2_lobes =
+{{
+    { 0.5f, 0.5f, 0.5f, 81.0f / 4.0f, Float(1) / 3 }
+}};
+
+// the lobes of l3 other than its second term, which is linear in y and z
+template<typename Float>
+inline constexpr std::array<gaussian_lobe<Float>, 3> l3_lobes =
+{{
+    { Float(2) / 9, Float(2) / 9, Float(2) / 9, 81.0f / 4.0f, 0.75f },
+    { Float(7) / 9, Float(3) / 9, Float(5) / 9, 81.0f / 4.0f, 0.5f },
+    { Float(4) / 9, Float(7) / 9, Float(5) / 9, 81.0f, -0.2f }
+}};
+
+// 7. renka_f4
+template<typename Float, typename Math = std_math>
+Float l1(Float const x, Float const y, Float const z)
+{
+    return gaussian_lobes<Float, Math>(l1_lobes<Float>, x, y, z);
+}
+
+template<typename Float, typename Math = std_math>
 Float l1(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::exp(-(81.0f / 16.0f) *
-        (std::pow(x - 0.5f, 2.0f) + std::pow(y - 0.5f, 2.0f) + std::pow(z - 0.5f, 2.0f))) / 3.0f;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return l1<Float, Math>(x, y, z);
 }
 
 // 8. renka_f5
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float l2(Float const x, Float const y, Float const z)
+{
+    return gaussian_lobes<Float, Math>(l2_lobes<Float>, x, y, z);
+}
+
+template<typename Float, typename Math = std_math>
 Float l2(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::exp(-(81.0f / 4.0f) *
-        (std::pow(x - 0.5f, 2.0f) + std::pow(y - 0.5f, 2.0f) + std::pow(z - 0.5f, 2.0f))) / 3.0f;
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return l2<Float, Math>(x, y, z);
 }
 
 // 13. From: "On spherical harmonics based numerical quadrature over the surface of a sphere"
 // fornberg_f2
-template<typename Float>
-Float l3(Float const theta, Float const phi)
+template<typename Float, typename Math = std_math>
+Float l3(Float const x, Float const y, Float const z)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return 0.75f * std::exp(-(9.0f * x - 2.0f) * (9.0f * x - 2.0f) / 4.0f -
-                (9.0f * y - 2.0f) * (9.0f * y - 2.0f) / 4.0f -
-                (9.0f * z - 2.0f) * (9.0f * z - 2.0f) / 4.0f) +
-            0.75f * std::exp(-(9.0f * x + 1.0f) * (9.0f * x + 1.0f) / 49.0f -
+    return gaussian_lobes<Float, Math>(l3_lobes<Float>, x, y, z) +
+            0.75f * Math::exp(-(9.0f * x + 1.0f) * (9.0f * x + 1.0f) / 49.0f -
                 (9.0f * y + 1.0f) / 10.0f -
-                (9.0f * z + 1.0f) / 10.0f) +
-            0.5f * std::exp(-(9.0f * x - 7.0f) * (9.0f * x - 7.0f) / 4.0f -
-                (9.0f * y - 3.0f) * (9.0f * y - 3.0f) / 4.0f -
-                (9.0f * z - 5.0f) * (9.0f * z - 5.0f) / 4.0f) -
-            0.2f * std::exp(-(9.0f * x - 4.0f) * (9.0f * x - 4.0f) -
-                (9.0f * y - 7.0f) * (9.0f * y - 7.0f) -
-                (9.0f * z - 5.0f) * (9.0f * z - 5.0f));
+                (9.0f * z + 1.0f) / 10.0f);
+}
+
+template<typename Float, typename Math = std_math>
+Float l3(Float const theta, Float const phi)
+{
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return l3<Float, Math>(x, y, z);
 }
 
 } // namespace lobes
@@ -247,49 +440,87 @@ namespace absolute_values
 {
 
 // 14. cf_f1
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float a1(Float const theta, Float const phi)
 {
-    return std::abs(std::sin(std::cos(2.0f * phi) - 2.0f * theta)) + std::abs(std::cos(2.0f * theta));
+    return Math::abs(Math::sin(Math::cos(2.0f * phi) - 2.0f * theta)) + Math::abs(Math::cos(2.0f * theta));
+}
+
+template<typename Float, typename Math = std_math>
+Float a1(Float const x, Float const y, Float const z)
+{
+    auto [theta, phi] = xyz_to_spherical<Float, Math>(x, y, z);
+    return a1<Float, Math>(theta, phi);
 }
 
 // 15. cf_f2
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float a2(Float const theta, Float const phi)
 {
-    return std::abs(std::sin(2.0f * phi - theta)) + std::abs(std::cos(2.0f * theta));
+    return Math::abs(Math::sin(2.0f * phi - theta)) + Math::abs(Math::cos(2.0f * theta));
+}
+
+template<typename Float, typename Math = std_math>
+Float a2(Float const x, Float const y, Float const z)
+{
+    auto [theta, phi] = xyz_to_spherical<Float, Math>(x, y, z);
+    return a2<Float, Math>(theta, phi);
 }
 
 // 20. cf_f7
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float a3(Float const x, Float const y, Float const z)
+{
+    return Math::abs(Math::cos(3.0f * x) + Math::sin(2.0f * y) + 0.5f * z * z);
+}
+
+template<typename Float, typename Math = std_math>
 Float a3(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::abs(std::cos(3.0f * x) + std::sin(2.0f * y) + 0.5f * z * z);
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return a3<Float, Math>(x, y, z);
 }
 
 // 21. cf_f8
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float a4(Float const x, Float const y, Float const z)
+{
+    return Math::abs(Math::sin(2.0f * x) * Math::cos(3.0f * y) + 0.5f * z * z + 0.3f * Math::sin(5.0f * x) * Math::cos(4.0f * z));
+}
+
+template<typename Float, typename Math = std_math>
 Float a4(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::abs(std::sin(2.0f * x) * std::cos(3.0f * y) + 0.5f * z * z + 0.3f * std::sin(5.0f * x) * std::cos(4.0f * z));
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return a4<Float, Math>(x, y, z);
 }
 
 // 22. cf_f9
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float a5(Float const x, Float const y, Float const z)
+{
+    return Math::abs(x * x - y * y + 0.5f * x * z - 0.3f * y * z);
+}
+
+template<typename Float, typename Math = std_math>
 Float a5(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::abs(x * x - y * y + 0.5f * x * z - 0.3f * y * z);
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return a5<Float, Math>(x, y, z);
 }
 
 // 24. cf_f11
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float a6(Float const x, Float const y, Float const z)
+{
+    return Math::abs(Math::sin(10.0f * x) * Math::cos(12.0f * y) * Math::sin(15.0f * z) + Math::cos(20.0f * x));
+}
+
+template<typename Float, typename Math = std_math>
 Float a6(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::abs(std::sin(10.0f * x) * std::cos(12.0f * y) * std::sin(15.0f * z) + std::cos(20.0f * x));
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return a6<Float, Math>(x, y, z);
 }
 
 } // namespace absolute_values
@@ -298,161 +529,668 @@ namespace zsymnetric
 {
 
 // 16. cf_f3
-template<typename Float>
+template<typename Float, typename Math = std_math>
 Float z1(Float const /*theta*/, Float const phi)
 {
-    return 1.0f + std::sin(5.0f * phi) / 5.0f;
+    return 1.0f + Math::sin(5.0f * phi) / 5.0f;
+}
+
+template<typename Float, typename Math = std_math>
+Float z1(Float const x, Float const y, Float const /*z*/)
+{
+    return 1.0f + Math::sin(5.0f * Math::atan2(y, x)) / 5.0f;
 }
 
 // 27. cf_f14
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float z2(Float const x, Float const y, Float const z)
+{
+    return Math::exp(-2.0f * (x * x + y * y)) * Math::sin(4.0f * z);
+}
+
+template<typename Float, typename Math = std_math>
 Float z2(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return std::exp(-2.0f * (x * x + y * y)) * std::sin(4.0f * z);
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return z2<Float, Math>(x, y, z);
 }
 
 // 28. cf_15
-template<typename Float>
+template<typename Float, typename Math = std_math>
+Float z3(Float const x, Float const y, Float const z)
+{
+    return (x * x + y * y) * Math::exp(-3.0f * z * z);
+}
+
+template<typename Float, typename Math = std_math>
 Float z3(Float const theta, Float const phi)
 {
-    auto [x, y, z] = spherical_to_xyz(theta, phi);
-    return (x * x + y * y) * std::exp(-3.0f * z * z);
+    auto [x, y, z] = spherical_to_xyz<Float, Math>(theta, phi);
+    return z3<Float, Math>(x, y, z);
 }
 
 } // namespace zsymmetric
 
+/**
+ * Function identifiers, in registry order
+ */
+enum class FunctionId : std::uint8_t
+{
+    p1,
+    d1, d2, d3, d4,
+    s1, s2, s3,
+    o1, o2, o3, o4, o5, o6, o7,
+    l1, l2, l3,
+    a1, a2, a3, a4, a5, a6,
+    z1, z2, z3
+};
+
+inline constexpr std::size_t function_count = 27;
+
+inline constexpr std::array<std::string_view, function_count> function_names =
+{
+    "p1",
+    "d1", "d2", "d3", "d4",
+    "s1", "s2", "s3",
+    "o1", "o2", "o3", "o4", "o5", "o6", "o7",
+    "l1", "l2", "l3",
+    "a1", "a2", "a3", "a4", "a5", "a6",
+    "z1", "z2", "z3"
+};
+
+/**
+ * Get the name of a function by its identifier
+ *
+ * @param id The identifier of the function
+ * @return The name of the function (e.g., "p1", "d1", "s1", etc.)
+ */
+constexpr std::string_view function_name(FunctionId const id)
+{
+    return function_names[static_cast<std::size_t>(id)];
+}
+
+/**
+ * Get a function identifier by its name
+ *
+ * @param name The name of the function (e.g., "p1", "d1", "s1", etc.)
+ * @return The identifier of the function
+ * @throws std::out_of_range if the name is unknown
+ */
+constexpr FunctionId function_id(std::string_view const name)
+{
+    for (std::size_t i = 0; i < function_count; ++i)
+        if (function_names[i] == name)
+            return static_cast<FunctionId>(i);
+
+    throw std::out_of_range("unknown spherical function");
+}
+
+template<typename Float>
+using function = Float (*)(Float, Float);
+
+template<typename Float>
+using function_xyz = Float (*)(Float, Float, Float);
+
+/**
+ * Batch signature: structure-of-arrays input angles and output values
+ */
+template<typename Float>
+using batch_function = void (*)(std::span<Float const>, std::span<Float const>, std::span<Float>);
+
+/**
+ * Batch signature: structure-of-arrays unit vectors and output values
+ */
+template<typename Float>
+using batch_function_xyz = void (*)(std::span<Float const>, std::span<Float const>, std::span<Float const>, std::span<Float>);
+
+/**
+ * Evaluate a function over contiguous arrays of angles
+ *
+ * The scalar template is inlined into a plain counted loop over raw pointers,
+ * which lets the compiler vectorize it.
+ *
+ * @param theta Polar angles
+ * @param phi Azimuthal angles, same size as theta
+ * @param out Output values, at least as large as theta
+ */
+template<typename Float, Float (*Fn)(Float, Float)>
+void eval_batch(std::span<Float const> theta, std::span<Float const> phi, std::span<Float> out)
+{
+    assert(phi.size() == theta.size() && out.size() >= theta.size());
+
+    Float const* __restrict t = theta.data();
+    Float const* __restrict p = phi.data();
+    Float* __restrict o = out.data();
+    std::size_t const n = theta.size();
+
+    for (std::size_t i = 0; i < n; ++i)
+        o[i] = Fn(t[i], p[i]);
+}
+
+/**
+ * Evaluate a function over contiguous arrays of unit vector components
+ *
+ * Point sets generated natively as unit vectors skip the spherical_to_xyz
+ * round trip entirely.
+ *
+ * @param x, y, z Unit vector components, all of the same size
+ * @param out Output values, at least as large as x
+ */
+template<typename Float, Float (*Fn)(Float, Float, Float)>
+void eval_batch_xyz(std::span<Float const> x, std::span<Float const> y, std::span<Float const> z, std::span<Float> out)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && out.size() >= x.size());
+
+    Float const* __restrict px = x.data();
+    Float const* __restrict py = y.data();
+    Float const* __restrict pz = z.data();
+    Float* __restrict o = out.data();
+    std::size_t const n = x.size();
+
+    for (std::size_t i = 0; i < n; ++i)
+        o[i] = Fn(px[i], py[i], pz[i]);
+}
+
+/**
+ * All entry points of a single function
+ */
+template<typename Float>
+struct function_entry
+{
+    function<Float> angles;
+    function_xyz<Float> xyz;
+    batch_function<Float> batch;
+    batch_function_xyz<Float> batch_xyz;
+};
+
+/**
+ * Compile-time function table indexed by FunctionId
+ *
+ * The batch entries are the SIMD kernels dispatched at runtime by CPU features;
+ * by default they evaluate with the vector_math policy, which is within a few
+ * ulp of the scalar std_math path (long double batches use std_math). Another
+ * policy, such as fast_math, selects a separate set of kernels.
+ */
+template<typename Float, typename BatchMath = batch_math<Float>>
+inline constexpr std::array<function_entry<Float>, function_count> function_table =
+{{
+    { &sphc::polynomial::p1<Float>, &sphc::polynomial::p1<Float>,
+      &eval_batch_simd<Float, sphc::polynomial::p1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::polynomial::p1<Float, BatchMath>> },
+    { &sphc::discontinuous::d1<Float>, &sphc::discontinuous::d1<Float>,
+      &eval_batch_simd<Float, sphc::discontinuous::d1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::discontinuous::d1<Float, BatchMath>> },
+    { &sphc::discontinuous::d2<Float>, &sphc::discontinuous::d2<Float>,
+      &eval_batch_simd<Float, sphc::discontinuous::d2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::discontinuous::d2<Float, BatchMath>> },
+    { &sphc::discontinuous::d3<Float>, &sphc::discontinuous::d3<Float>,
+      &eval_batch_simd<Float, sphc::discontinuous::d3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::discontinuous::d3<Float, BatchMath>> },
+    { &sphc::discontinuous::d4<Float>, &sphc::discontinuous::d4<Float>,
+      &eval_batch_simd<Float, sphc::discontinuous::d4<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::discontinuous::d4<Float, BatchMath>> },
+    { &sphc::smooth_approx::s1<Float>, &sphc::smooth_approx::s1<Float>,
+      &eval_batch_simd<Float, sphc::smooth_approx::s1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::smooth_approx::s1<Float, BatchMath>> },
+    { &sphc::smooth_approx::s2<Float>, &sphc::smooth_approx::s2<Float>,
+      &eval_batch_simd<Float, sphc::smooth_approx::s2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::smooth_approx::s2<Float, BatchMath>> },
+    { &sphc::smooth_approx::s3<Float>, &sphc::smooth_approx::s3<Float>,
+      &eval_batch_simd<Float, sphc::smooth_approx::s3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::smooth_approx::s3<Float, BatchMath>> },
+    { &sphc::oscillatory::o1<Float>, &sphc::oscillatory::o1<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o1<Float, BatchMath>> },
+    { &sphc::oscillatory::o2<Float>, &sphc::oscillatory::o2<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o2<Float, BatchMath>> },
+    { &sphc::oscillatory::o3<Float>, &sphc::oscillatory::o3<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o3<Float, BatchMath>> },
+    { &sphc::oscillatory::o4<Float>, &sphc::oscillatory::o4<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o4<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o4<Float, BatchMath>> },
+    { &sphc::oscillatory::o5<Float>, &sphc::oscillatory::o5<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o5<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o5<Float, BatchMath>> },
+    { &sphc::oscillatory::o6<Float>, &sphc::oscillatory::o6<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o6<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o6<Float, BatchMath>> },
+    { &sphc::oscillatory::o7<Float>, &sphc::oscillatory::o7<Float>,
+      &eval_batch_simd<Float, sphc::oscillatory::o7<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::oscillatory::o7<Float, BatchMath>> },
+    { &sphc::lobes::l1<Float>, &sphc::lobes::l1<Float>,
+      &eval_batch_simd<Float, sphc::lobes::l1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::lobes::l1<Float, BatchMath>> },
+    { &sphc::lobes::l2<Float>, &sphc::lobes::l2<Float>,
+      &eval_batch_simd<Float, sphc::lobes::l2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::lobes::l2<Float, BatchMath>> },
+    { &sphc::lobes::l3<Float>, &sphc::lobes::l3<Float>,
+      &eval_batch_simd<Float, sphc::lobes::l3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::lobes::l3<Float, BatchMath>> },
+    { &sphc::absolute_values::a1<Float>, &sphc::absolute_values::a1<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a1<Float, BatchMath>> },
+    { &sphc::absolute_values::a2<Float>, &sphc::absolute_values::a2<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a2<Float, BatchMath>> },
+    { &sphc::absolute_values::a3<Float>, &sphc::absolute_values::a3<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a3<Float, BatchMath>> },
+    { &sphc::absolute_values::a4<Float>, &sphc::absolute_values::a4<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a4<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a4<Float, BatchMath>> },
+    { &sphc::absolute_values::a5<Float>, &sphc::absolute_values::a5<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a5<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a5<Float, BatchMath>> },
+    { &sphc::absolute_values::a6<Float>, &sphc::absolute_values::a6<Float>,
+      &eval_batch_simd<Float, sphc::absolute_values::a6<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::absolute_values::a6<Float, BatchMath>> },
+    { &sphc::zsymnetric::z1<Float>, &sphc::zsymnetric::z1<Float>,
+      &eval_batch_simd<Float, sphc::zsymnetric::z1<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::zsymnetric::z1<Float, BatchMath>> },
+    { &sphc::zsymnetric::z2<Float>, &sphc::zsymnetric::z2<Float>,
+      &eval_batch_simd<Float, sphc::zsymnetric::z2<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::zsymnetric::z2<Float, BatchMath>> },
+    { &sphc::zsymnetric::z3<Float>, &sphc::zsymnetric::z3<Float>,
+      &eval_batch_simd<Float, sphc::zsymnetric::z3<Float, BatchMath>>,
+      &eval_batch_xyz_simd<Float, sphc::zsymnetric::z3<Float, BatchMath>> }
+}};
+
 /**
  * Get a function by its identifier
  *
- * @param id The identifier of the function (e.g., "p1", "d1", "s1", etc.)
- * @return A std::function that takes two Float arguments (theta and phi) and returns a Float
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
+ * @return A pointer to the function taking two Float arguments (theta and phi)
  */
 template<typename Float>
-std::function<Float(Float, Float)> get_function(std::string const& id)
+constexpr function<Float> get_function(FunctionId const id)
 {
-    static std::unordered_map<std::string, std::function<Float(Float, Float)>> functions =
-    {
-        { "p1", &sphc::polynomial::p1<Float> },
-        { "d1", &sphc::discontinuous::d1<Float> },
-        { "d2", &sphc::discontinuous::d2<Float> },
-        { "d3", &sphc::discontinuous::d3<Float> },
-        { "d4", &sphc::discontinuous::d4<Float> },
-        { "s1", &sphc::smooth_approx::s1<Float> },
-        { "s2", &sphc::smooth_approx::s2<Float> },
-        { "s3", &sphc::smooth_approx::s3<Float> },
-        { "o1", &sphc::oscillatory::o1<Float> },
-        { "o2", &sphc::oscillatory::o2<Float> },
-        { "o3", &sphc::oscillatory::o3<Float> },
-        { "o4", &sphc::oscillatory::o4<Float> },
-        { "o5", &sphc::oscillatory::o5<Float> },
-        { "o6", &sphc::oscillatory::o6<Float> },
-        { "o7", &sphc::oscillatory::o7<Float> },
-        { "l1", &sphc::lobes::l1<Float> },
-        { "l2", &sphc::lobes::l2<Float> },
-        { "l3", &sphc::lobes::l3<Float> },
-        { "a1", &sphc::absolute_values::a1<Float> },
-        { "a2", &sphc::absolute_values::a2<Float> },
-        { "a3", &sphc::absolute_values::a3<Float> },
-        { "a4", &sphc::absolute_values::a4<Float> },
-        { "a5", &sphc::absolute_values::a5<Float> },
-        { "a6", &sphc::absolute_values::a6<Float> },
-        { "z1", &sphc::zsymnetric::z1<Float> },
-        { "z2", &sphc::zsymnetric::z2<Float> },
-        { "z3", &sphc::zsymnetric::z3<Float> }
-    };
-
-    return functions.at(id);
+    return function_table<Float>[static_cast<std::size_t>(id)].angles;
 }
 
 template<typename Float>
-Float eval_function(std::string const& id, Float theta, Float phi)
+constexpr function<Float> get_function(std::string_view const id)
 {
-    return (get_function<Float>(id))(theta, phi);
+    return get_function<Float>(function_id(id));
 }
 
+/**
+ * Get a function taking a unit vector (x, y, z) by its identifier
+ */
+template<typename Float>
+constexpr function_xyz<Float> get_function_xyz(FunctionId const id)
+{
+    return function_table<Float>[static_cast<std::size_t>(id)].xyz;
+}
+
+template<typename Float>
+constexpr function_xyz<Float> get_function_xyz(std::string_view const id)
+{
+    return get_function_xyz<Float>(function_id(id));
+}
+
+template<typename Float>
+Float eval_function(FunctionId const id, Float theta, Float phi)
+{
+    return get_function<Float>(id)(theta, phi);
+}
+
+template<typename Float>
+Float eval_function(std::string_view const id, Float theta, Float phi)
+{
+    return get_function<Float>(id)(theta, phi);
+}
+
+/**
+ * Get a batch evaluator by its identifier
+ *
+ * @tparam Math Math policy of the kernel, e.g. fast_math
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
+ * @return A pointer to the eval_batch instantiation of the function
+ */
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_function<Float> get_batch_function(FunctionId const id)
+{
+    return function_table<Float, Math>[static_cast<std::size_t>(id)].batch;
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_function<Float> get_batch_function(std::string_view const id)
+{
+    return get_batch_function<Float, Math>(function_id(id));
+}
+
+/**
+ * Evaluate a function by its identifier over contiguous arrays of angles
+ */
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch(FunctionId const id, std::span<Float const> theta, std::span<Float const> phi, std::span<Float> out)
+{
+    get_batch_function<Float, Math>(id)(theta, phi, out);
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch(std::string_view const id, std::span<Float const> theta, std::span<Float const> phi, std::span<Float> out)
+{
+    get_batch_function<Float, Math>(id)(theta, phi, out);
+}
+
+/**
+ * Get a unit vector batch evaluator by its identifier
+ *
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
+ * @return A pointer to the eval_batch_xyz instantiation of the function
+ */
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_function_xyz<Float> get_batch_function_xyz(FunctionId const id)
+{
+    return function_table<Float, Math>[static_cast<std::size_t>(id)].batch_xyz;
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+constexpr batch_function_xyz<Float> get_batch_function_xyz(std::string_view const id)
+{
+    return get_batch_function_xyz<Float, Math>(function_id(id));
+}
+
+/**
+ * Evaluate a function by its identifier over contiguous arrays of unit vectors
+ */
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch_xyz(FunctionId const id, std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+    std::span<Float> out)
+{
+    get_batch_function_xyz<Float, Math>(id)(x, y, z, out);
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch_xyz(std::string_view const id, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> out)
+{
+    get_batch_function_xyz<Float, Math>(id)(x, y, z, out);
+}
+
+/**
+ * Surface integrals, indexed by FunctionId
+ *
+ * Computed in long double by tools/reference (build target reference_tables,
+ * verified by check_reference); values known in closed form are written so.
+ */
+inline constexpr std::array<double, function_count> integrals =
+{
+    19.388114662154152,              // p1
+    4.0 * std::numbers::pi / 9.0,    // d1
+    4.0 * std::numbers::pi / 9.0,    // d2
+    4.0 * std::numbers::pi / 9.0,    // d3
+    std::numbers::pi,                // d4
+    4.0 * std::numbers::pi / 9.0,    // s1
+    0.049629919464651624,            // s2
+    4.0634438776672344,              // s3
+    0.12928068862091721,             // o1
+    75.39435094754468,               // o2
+    37.032356394973327,              // o3
+    20.78997562091557,               // o4
+    4.0 * std::numbers::pi,          // o5
+    54.311111049954889,              // o6
+    4.0 * std::numbers::pi,          // o7
+    0.2181069784106614,              // l1
+    0.041516376842587292,            // l2
+    6.6961822199870999,              // l3
+    15.732350158836278,              // a1
+    15.658897630302585,              // a2
+    11.548385730244414,              // a3
+    5.7018040208893668,              // a4
+    5.5630281285019691,              // a5
+    8.5842002387292133,              // a6
+    4.0 * std::numbers::pi,          // z1
+    0.0,                             // z2
+    5.3857472045135344               // z3
+};
+
+/**
+ * Global maxima, indexed by FunctionId, computed by tools/reference
+ */
+inline constexpr std::array<double, function_count> maximums =
+{
+    3.147662422390018,               // p1
+    2.0 / 9.0,                       // d1
+    2.0 / 9.0,                       // d2
+    2.0 / 9.0,                       // d3
+    1.0,                             // d4
+    0.22222222222221583,             // s1
+    0.50954801625562263,             // s2
+    0.99950761407771305,             // s3
+    0.31676347062879995,             // o1
+    8.4729678015542635,              // o2
+    5.9997036966824071,              // o3
+    7.6884615016440003,              // o4
+    2.2,                             // o5
+    6.9121123855075739,              // o6
+    1.800000011920929,               // o7
+    0.30437947732666598,             // l1
+    0.23175292913870249,             // l2
+    2.180230740197953,               // l3
+    1.9190992599695809,              // a1
+    2.0,                             // a2
+    2.2536754405363792,              // a3
+    1.3673556083932785,              // a4
+    1.05959904144262,                // a5
+    1.9963217394236681,              // a6
+    1.2,                             // z1
+    0.7568024953079282,              // z2
+    1.0                              // z3
+};
+
+/**
+ * Global minima, indexed by FunctionId, computed by tools/reference
+ */
+inline constexpr std::array<double, function_count> minimums =
+{
+    0.4901684059875145,              // p1
+    0.0,                             // d1
+    0.0,                             // d2
+    0.0,                             // d3
+    0.0,                             // d4
+    6.409520146500376e-15,           // s1
+    0.0005305564162369637,           // s2
+    0.0002351861176971885,           // s3
+    -0.16579578162857242,            // o1
+    3.5030084251669624,              // o2
+    -0.18682822673648536,            // o3
+    -0.16120354386081986,            // o4
+    -0.2,                            // o5
+    2.163510987749517,               // o6
+    0.19999998807907104,             // o7
+    7.365237783204154e-09,           // l1
+    7.945310130252456e-32,           // l2
+    -0.033359714484251436,           // l3
+    0.5403023058681398,              // a1
+    0.0,                             // a2
+    0.0,                             // a3
+    0.0,                             // a4
+    0.0,                             // a5
+    0.0,                             // a6
+    0.8,                             // z1
+    -0.7568024953079282,             // z2
+    0.0                              // z3
+};
+
 /**
  * Get function integral by its identifier
- * @param id The identifier of the function (e.g., "p1", "d1", "s1", etc.)
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
  * @return Surface integral value
  */
 template<typename Float>
-Float get_integral(std::string const& id)
+constexpr Float get_integral(FunctionId const id)
 {
-    static std::unordered_map<std::string, Float> integrals =
-    {
-        { "p1", 19.3881 },
-        { "d1", 1.3962 },
-        { "d2", 4.0 * M_PI / 9.0 },
-        { "d3", 4.0 * M_PI / 9.0 },
-        { "d4", M_PI },
-        { "s1", 4.0 * M_PI / 9.0 },
-        { "s2", 0.0496 },
-        { "s3", 4.0634 },
-        { "o1", 0.1292 },
-        { "o2", 75.3944 },
-        { "o3", 37.0324 },
-        { "o4", 20.79 },
-        { "o5", 12.5664 },
-        { "o6", 54.3111 },
-        { "o7", 12.5664 },
-        { "l1", 0.2181 },
-        { "l2", 0.0415 },
-        { "l3", 6.6961 },
-        { "a1", 15.7323 },
-        { "a2", 15.6589 },
-        { "a3", 11.5484 },
-        { "a4", 5.7017 },
-        { "a5", 5.5630 },
-        { "a6", 8.5842 },
-        { "z1", 12.5664 },
-        { "z2", 0.0 },
-        { "z3", 5.3857 }
-    };
-
-    return static_cast<Float>(integrals.at(id));
+    return static_cast<Float>(integrals[static_cast<std::size_t>(id)]);
+}
+
+template<typename Float>
+constexpr Float get_integral(std::string_view const id)
+{
+    return get_integral<Float>(function_id(id));
 }
 
 /**
  * Get function maximum by its identifier
- * @param id The identifier of the function (e.g., "p1", "d1", "s1", etc.)
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
  * @return Global maximum value
  */
 template<typename Float>
-Float get_maximum(std::string const& id)
+constexpr Float get_maximum(FunctionId const id)
+{
+    return static_cast<Float>(maximums[static_cast<std::size_t>(id)]);
+}
+
+template<typename Float>
+constexpr Float get_maximum(std::string_view const id)
+{
+    return get_maximum<Float>(function_id(id));
+}
+
+/**
+ * Get function minimum by its identifier
+ * @param id The identifier of the function (e.g., FunctionId::p1 or "p1")
+ * @return Global minimum value
+ */
+template<typename Float>
+constexpr Float get_minimum(FunctionId const id)
 {
-    static std::unordered_map<std::string, Float> maximums =
+    return static_cast<Float>(minimums[static_cast<std::size_t>(id)]);
+}
+
+template<typename Float>
+constexpr Float get_minimum(std::string_view const id)
+{
+    return get_minimum<Float>(function_id(id));
+}
+
+/**
+ * Plane n . p = offset across which a discontinuous function jumps
+ *
+ * The coefficients are those of the definition, scaled to small integers where
+ * exact; n is not normalized.
+ */
+struct discontinuity_plane
+{
+    double nx, ny, nz;
+    double offset;
+};
+
+/**
+ * Get the discontinuity plane of a function by its identifier
+ * @param id The identifier of the function (e.g., FunctionId::d1 or "d1")
+ * @return The plane of d1 - d4, std::nullopt for the continuous functions
+ */
+constexpr std::optional<discontinuity_plane> get_discontinuity_plane(FunctionId const id)
+{
+    switch (id)
     {
-        { "p1", 3.1476 },
-        { "d1", 0.2222 },
-        { "d2", 0.2222 },
-        { "d3", 0.2222 },
-        { "d4", 1.0 },
-        { "s1", 0.2222 },
-        { "s2", 0.5095 },
-        { "s3", 0.9995 },
-        { "o1", 0.3168 },
-        { "o2", 8.4730 },
-        { "o3", 5.9997 },
-        { "o4", 7.6885 },
-        { "o5", 2.2 },
-        { "o6", 6.9121 },
-        { "o7", 1.8 },
-        { "l1", 0.3043 },
-        { "l2", 0.2317 },
-        { "l3", 2.1802 },
-        { "a1", 1.9191 },
-        { "a2", 2 },
-        { "a3", 2.2536 },
-        { "a4", 1.3673 },
-        { "a5", 1.0596 },
-        { "a6", 1.9963 },
-        { "z1", 1.2 },
-        { "z2", 0.7568 },
-        { "z3", 1 }
-    };
-
-    return static_cast<Float>(maximums.at(id));
+        case FunctionId::d1: return discontinuity_plane{ -1.0, -1.0, 1.0, 0.0 };
+        case FunctionId::d2: return discontinuity_plane{ 1.0, 1.0, -1.0, 0.0 };
+        case FunctionId::d3: return discontinuity_plane{ F_PI, 1.0, 0.0, 0.0 };
+        case FunctionId::d4: return discontinuity_plane{ 1.0, 0.0, 0.0, 0.5 };
+        default: return std::nullopt;
+    }
+}
+
+constexpr std::optional<discontinuity_plane> get_discontinuity_plane(std::string_view const id)
+{
+    return get_discontinuity_plane(function_id(id));
+}
+
+/**
+ * Regularity classes, from the most to the least regular; a function is
+ * classed by its worst point
+ */
+enum class smoothness : std::uint8_t
+{
+    analytic,
+    steep,              // smooth, but with sharp transitions
+    kink,               // continuous, with jumps of the gradient
+    jump                // discontinuous
+};
+
+/**
+ * Structure of a function in (theta, phi) that integration can exploit
+ */
+enum class structure : std::uint8_t
+{
+    general,
+    zonal,              // depends on theta only
+    azimuthal,          // depends on phi only
+    separable,          // g(theta) + h(phi)
+    half_space          // constant on either side of its discontinuity plane
+};
+
+/**
+ * Known sets on which a function is discontinuous
+ */
+enum class discontinuity_set : std::uint8_t
+{
+    none,
+    plane,              // see get_discontinuity_plane
+    poles               // varies with phi arbitrarily close to a pole
+};
+
+struct function_metadata
+{
+    structure form;
+    smoothness regularity;
+    discontinuity_set discontinuities;
+    bool depends_on_phi;
+    std::int8_t z_parity;               // 1 if f(x, y, -z) = f(x, y, z), -1 if f(x, y, -z) = -f(x, y, z), else 0
+};
+
+/**
+ * Per-function metadata, indexed by FunctionId
+ */
+inline constexpr std::array<function_metadata, function_count> metadata =
+{{
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 1 },        // p1
+    { structure::half_space, smoothness::jump, discontinuity_set::plane, true, 0 },        // d1
+    { structure::half_space, smoothness::jump, discontinuity_set::plane, true, 0 },        // d2
+    { structure::half_space, smoothness::jump, discontinuity_set::plane, true, 1 },        // d3
+    { structure::half_space, smoothness::jump, discontinuity_set::plane, true, 1 },        // d4
+    { structure::general, smoothness::steep, discontinuity_set::none, true, 0 },           // s1
+    { structure::zonal, smoothness::steep, discontinuity_set::none, false, 0 },            // s2
+    { structure::zonal, smoothness::steep, discontinuity_set::none, false, 0 },            // s3
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 1 },        // o1
+    { structure::zonal, smoothness::kink, discontinuity_set::none, false, 0 },             // o2, at the south pole
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 0 },        // o3
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 0 },        // o4
+    { structure::separable, smoothness::jump, discontinuity_set::poles, true, 1 },         // o5
+    { structure::general, smoothness::jump, discontinuity_set::poles, true, 0 },           // o6
+    { structure::separable, smoothness::jump, discontinuity_set::poles, true, 0 },         // o7
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 0 },        // l1
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 0 },        // l2
+    { structure::general, smoothness::analytic, discontinuity_set::none, true, 0 },        // l3
+    { structure::general, smoothness::jump, discontinuity_set::poles, true, 0 },           // a1
+    { structure::general, smoothness::jump, discontinuity_set::poles, true, 0 },           // a2
+    { structure::general, smoothness::kink, discontinuity_set::none, true, 1 },            // a3
+    { structure::general, smoothness::kink, discontinuity_set::none, true, 1 },            // a4
+    { structure::general, smoothness::kink, discontinuity_set::none, true, 0 },            // a5
+    { structure::general, smoothness::kink, discontinuity_set::none, true, 0 },            // a6
+    { structure::azimuthal, smoothness::jump, discontinuity_set::poles, true, 1 },         // z1
+    { structure::zonal, smoothness::analytic, discontinuity_set::none, false, -1 },        // z2
+    { structure::zonal, smoothness::analytic, discontinuity_set::none, false, 1 }          // z3
+}};
+
+/**
+ * Get the metadata of a function by its identifier
+ * @param id The identifier of the function (e.g., FunctionId::z1 or "z1")
+ * @return The metadata record
+ */
+constexpr function_metadata get_metadata(FunctionId const id)
+{
+    return metadata[static_cast<std::size_t>(id)];
+}
+
+constexpr function_metadata get_metadata(std::string_view const id)
+{
+    return get_metadata(function_id(id));
 }
 
 } // namespace sphc
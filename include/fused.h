@@ -0,0 +1,208 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_FUSED_H
+#define SPHERICAL_COLLECTION_FUSED_H
+
+#include <array>
+#include <span>
+#include <tuple>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+#include "functions.h"
+#include "simd.h"
+#include "vmath.h"
+
+namespace sphc
+{
+
+/**
+ * Functions whose unit vector overloads convert back to (theta, phi) first
+ *
+ * o7 and z1 are written in angles as well, but their unit vector overloads
+ * only take the azimuth by atan2(y, x), so they are evaluated on the unit
+ * vector and do not make eval_fused_xyz compute the polar angle.
+ */
+inline constexpr std::array<bool, function_count> defined_in_angles =
+{
+    false,                          // p1
+    false, false, false, false,     // d1 - d4
+    false, false, false,            // s1 - s3
+    false, false, false, false,     // o1 - o4
+    true, true, false,              // o5 - o7
+    false, false, false,            // l1 - l3
+    true, true,                     // a1, a2
+    false, false, false, false,     // a3 - a6
+    false,                          // z1
+    false, false                    // z2, z3
+};
+
+/**
+ * Points per tile of the fused evaluators; the coordinate scratch of a tile
+ * stays in L1 while every requested function sweeps over it
+ */
+inline constexpr std::size_t fused_tile = 256;
+
+namespace
+{
+
+template<typename Float, typename Math>
+void unit_vector(Float const theta, Float const phi, Float& x, Float& y, Float& z)
+{
+    std::tie(x, y, z) = spherical_to_xyz<Float, Math>(theta, phi);
+}
+
+template<typename Float, typename Math>
+Float polar_angle(Float const x, Float const y, Float const z)
+{
+    return std::get<0>(xyz_to_spherical<Float, Math>(x, y, z));
+}
+
+template<typename Float, typename Math>
+Float azimuth(Float const x, Float const y, Float const /*z*/)
+{
+    return Math::atan2(y, x);
+}
+
+inline bool needs_angles(std::span<FunctionId const> ids)
+{
+    return std::any_of(ids.begin(), ids.end(),
+        [](FunctionId const id) { return defined_in_angles[static_cast<std::size_t>(id)]; });
+}
+
+inline bool needs_xyz(std::span<FunctionId const> ids)
+{
+    return std::any_of(ids.begin(), ids.end(),
+        [](FunctionId const id) { return !defined_in_angles[static_cast<std::size_t>(id)]; });
+}
+
+// every function in registry order
+inline constexpr std::array<FunctionId, function_count> all_functions = []()
+{
+    std::array<FunctionId, function_count> ids{};
+    for (std::size_t i = 0; i < function_count; ++i)
+        ids[i] = static_cast<FunctionId>(i);
+    return ids;
+}();
+
+template<typename Float>
+void eval_tile(std::span<FunctionId const> ids, std::span<Float const> theta, std::span<Float const> phi,
+    std::span<Float const> x, std::span<Float const> y, std::span<Float const> z, std::span<Float> out,
+    std::size_t const stride, std::size_t const first)
+{
+    std::size_t const count = x.size();
+    for (std::size_t k = 0; k < ids.size(); ++k)
+    {
+        std::size_t const id = static_cast<std::size_t>(ids[k]);
+        std::span<Float> const row = out.subspan(k * stride + first, count);
+        if (defined_in_angles[id])
+            function_table<Float>[id].batch(theta, phi, row);
+        else
+            function_table<Float>[id].batch_xyz(x, y, z, row);
+    }
+}
+
+} // namespace
+
+/**
+ * Evaluate several functions over one set of angles
+ *
+ * Points are processed in tiles: the unit vectors of a tile are computed once,
+ * in a single pass with one sincos per angle, and shared by every function
+ * defined on the unit vector, the others read the angles directly, so no
+ * function repeats the coordinate conversion.
+ *
+ * @param ids Functions to evaluate, one output row each
+ * @param theta Polar angles
+ * @param phi Azimuthal angles, same size as theta
+ * @param out Function x point buffer, row k holds ids[k] at out[k * theta.size() + i]
+ */
+template<typename Float>
+void eval_fused(std::span<FunctionId const> ids, std::span<Float const> theta, std::span<Float const> phi,
+    std::span<Float> out)
+{
+    assert(phi.size() == theta.size() && out.size() >= ids.size() * theta.size());
+
+    using Math = batch_math<Float>;
+    bool const xyz = needs_xyz(ids);
+    std::size_t const n = theta.size();
+
+    alignas(64) Float x[fused_tile], y[fused_tile], z[fused_tile];
+    for (std::size_t first = 0; first < n; first += fused_tile)
+    {
+        std::size_t const count = std::min(fused_tile, n - first);
+        std::span<Float const> const t = theta.subspan(first, count);
+        std::span<Float const> const p = phi.subspan(first, count);
+        if (xyz)
+            eval_batch3_simd<Float, unit_vector<Float, Math>>(t, p, { x, count }, { y, count }, { z, count });
+        eval_tile<Float>(ids, t, p, { x, count }, { y, count }, { z, count }, out, n, first);
+    }
+}
+
+/**
+ * Evaluate all functions over one set of angles
+ *
+ * @param out Function x point buffer of function_count rows, indexed by FunctionId
+ */
+template<typename Float>
+void eval_fused(std::span<Float const> theta, std::span<Float const> phi, std::span<Float> out)
+{
+    eval_fused<Float>(all_functions, theta, phi, out);
+}
+
+/**
+ * Evaluate several functions over one set of unit vectors
+ *
+ * The angles of a tile are computed once, and only if a requested function is
+ * defined in angles.
+ *
+ * @param ids Functions to evaluate, one output row each
+ * @param x, y, z Unit vector components, all of the same size
+ * @param out Function x point buffer, row k holds ids[k] at out[k * x.size() + i]
+ */
+template<typename Float>
+void eval_fused_xyz(std::span<FunctionId const> ids, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> out)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && out.size() >= ids.size() * x.size());
+
+    using Math = batch_math<Float>;
+    bool const angles = needs_angles(ids);
+    std::size_t const n = x.size();
+
+    alignas(64) Float theta[fused_tile], phi[fused_tile];
+    for (std::size_t first = 0; first < n; first += fused_tile)
+    {
+        std::size_t const count = std::min(fused_tile, n - first);
+        std::span<Float const> const px = x.subspan(first, count);
+        std::span<Float const> const py = y.subspan(first, count);
+        std::span<Float const> const pz = z.subspan(first, count);
+        if (angles)
+        {
+            eval_batch_xyz_simd<Float, polar_angle<Float, Math>>(px, py, pz, { theta, count });
+            eval_batch_xyz_simd<Float, azimuth<Float, Math>>(px, py, pz, { phi, count });
+        }
+        eval_tile<Float>(ids, { theta, count }, { phi, count }, px, py, pz, out, n, first);
+    }
+}
+
+/**
+ * Evaluate all functions over one set of unit vectors
+ *
+ * @param out Function x point buffer of function_count rows, indexed by FunctionId
+ */
+template<typename Float>
+void eval_fused_xyz(std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+    std::span<Float> out)
+{
+    eval_fused_xyz<Float>(all_functions, x, y, z, out);
+}
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_FUSED_H
@@ -0,0 +1,180 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_GRID_H
+#define SPHERICAL_COLLECTION_GRID_H
+
+#include <span>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <numbers>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+
+#include "functions.h"
+#include "parallel.h"
+
+namespace sphc
+{
+
+/**
+ * Parallel evaluation of functions on equirectangular (theta, phi) grids
+ */
+namespace grid
+{
+
+/**
+ * Row-major equirectangular raster, sampled at cell centers
+ *
+ * The storage is left uninitialized on construction so that each page is
+ * first touched, and therefore placed, by the worker that evaluates it.
+ */
+template<typename Float>
+struct equirectangular
+{
+    std::size_t rows;                   // theta cells over [0, pi]
+    std::size_t columns;                // phi cells over [0, 2 pi)
+    std::unique_ptr<Float[]> values;
+
+    equirectangular(std::size_t const rows, std::size_t const columns)
+        : rows(rows), columns(columns), values(new Float[rows * columns])
+    {
+    }
+
+    Float theta(std::size_t const row) const
+    {
+        return static_cast<Float>((static_cast<double>(row) + 0.5) * std::numbers::pi / static_cast<double>(rows));
+    }
+
+    Float phi(std::size_t const column) const
+    {
+        return static_cast<Float>((static_cast<double>(column) + 0.5) * 2.0 * std::numbers::pi /
+            static_cast<double>(columns));
+    }
+
+    Float& operator()(std::size_t const row, std::size_t const column) { return values[row * columns + column]; }
+    Float operator()(std::size_t const row, std::size_t const column) const { return values[row * columns + column]; }
+};
+
+struct options
+{
+    unsigned threads = 0;               // 0 for hardware concurrency
+    std::size_t tile_rows = 8;          // the default 8 x 512 tile is 16-32 KiB of output
+    std::size_t tile_columns = 512;
+    bool pin_threads = false;           // see parallel_for
+};
+
+struct throughput
+{
+    double seconds;
+    double evals_per_second;
+    std::size_t tiles;
+    schedule_stats schedule;
+};
+
+namespace
+{
+
+/**
+ * Evaluate every tile of a grid; segment(row, first_column, count, phi, worker)
+ * fills one row segment of a tile
+ */
+template<typename Float, typename Segment>
+throughput evaluate_tiles(equirectangular<Float>& g, options const& opt, Segment&& segment)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    std::vector<Float> phi(g.columns);
+    for (std::size_t j = 0; j < g.columns; ++j)
+        phi[j] = g.phi(j);
+
+    std::size_t const tile_rows = std::max<std::size_t>(opt.tile_rows, 1);
+    std::size_t const tile_columns = std::max<std::size_t>(opt.tile_columns, 1);
+    std::size_t const tiles_down = (g.rows + tile_rows - 1) / tile_rows;
+    std::size_t const tiles_across = (g.columns + tile_columns - 1) / tile_columns;
+    std::size_t const tiles = tiles_down * tiles_across;
+
+    schedule_stats const schedule = parallel_for(tiles, opt.threads, opt.pin_threads,
+        [&](std::size_t const tile, unsigned const worker)
+        {
+            std::size_t const row0 = (tile / tiles_across) * tile_rows;
+            std::size_t const column0 = (tile % tiles_across) * tile_columns;
+            std::size_t const row1 = std::min(row0 + tile_rows, g.rows);
+            std::size_t const count = std::min(tile_columns, g.columns - column0);
+            for (std::size_t i = row0; i < row1; ++i)
+                segment(i, column0, count, std::span<Float const>(phi).subspan(column0, count), worker);
+        });
+
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double const evals = static_cast<double>(g.rows * g.columns);
+    return { seconds, seconds > 0.0 ? evals / seconds : 0.0, tiles, schedule };
+}
+
+} // namespace
+
+/**
+ * Evaluate a scalar function, such as one from get_function, on a grid
+ *
+ * @param fn Function of (theta, phi)
+ * @param g Grid to fill
+ * @param opt Threading and tiling options
+ * @return Achieved throughput
+ */
+template<typename Float>
+throughput evaluate(function<Float> const fn, equirectangular<Float>& g, options const& opt = {})
+{
+    return evaluate_tiles(g, opt,
+        [&](std::size_t const row, std::size_t const column0, std::size_t const count, std::span<Float const> phi,
+            unsigned /*worker*/)
+        {
+            Float const theta = g.theta(row);
+            Float* out = &g(row, column0);
+            for (std::size_t j = 0; j < count; ++j)
+                out[j] = fn(theta, phi[j]);
+        });
+}
+
+/**
+ * Evaluate a registered function on a grid with its dispatched SIMD kernel
+ *
+ * @param id The identifier of the function
+ * @param g Grid to fill
+ * @param opt Threading and tiling options
+ * @return Achieved throughput
+ */
+template<typename Float>
+throughput evaluate(FunctionId const id, equirectangular<Float>& g, options const& opt = {})
+{
+    batch_function<Float> const fn = get_batch_function<Float>(id);
+
+    // per-worker row of the constant polar angle of a segment
+    unsigned const threads = opt.threads != 0 ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::vector<Float>> theta(threads, std::vector<Float>(std::max<std::size_t>(opt.tile_columns, 1)));
+
+    return evaluate_tiles(g, opt,
+        [&](std::size_t const row, std::size_t const column0, std::size_t const count, std::span<Float const> phi,
+            unsigned const worker)
+        {
+            std::span<Float> const t = std::span<Float>(theta[worker]).first(count);
+            std::fill(t.begin(), t.end(), g.theta(row));
+            fn(t, phi, { &g(row, column0), count });
+        });
+}
+
+template<typename Float>
+throughput evaluate(std::string_view const id, equirectangular<Float>& g, options const& opt = {})
+{
+    return evaluate<Float>(function_id(id), g, opt);
+}
+
+} // namespace grid
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_GRID_H
@@ -0,0 +1,174 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_MONTECARLO_H
+#define SPHERICAL_COLLECTION_MONTECARLO_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <span>
+#include <vector>
+#include <numbers>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "functions.h"
+#include "random.h"
+
+namespace sphc
+{
+
+/**
+ * Uniform Monte Carlo integration over the sphere
+ */
+namespace montecarlo
+{
+
+/**
+ * Samples per block; blocks are the unit of work and of reduction, so results
+ * do not depend on how blocks are spread over threads
+ */
+inline constexpr std::size_t block_size = 4096;
+
+template<typename Float>
+struct result
+{
+    Float estimate;             // surface integral estimate
+    Float variance;             // variance of the estimate
+    std::size_t samples;
+    double samples_per_second;
+};
+
+namespace
+{
+
+struct block_moments
+{
+    std::size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;            // sum of squared deviations from the mean
+};
+
+// Chan et al. pairwise combination of mean and M2
+inline void merge(block_moments& a, block_moments const& b)
+{
+    if (b.count == 0)
+        return;
+
+    double const n = static_cast<double>(a.count + b.count);
+    double const delta = b.mean - a.mean;
+    a.mean += delta * static_cast<double>(b.count) / n;
+    a.m2 += b.m2 + delta * delta * static_cast<double>(a.count) * static_cast<double>(b.count) / n;
+    a.count += b.count;
+}
+
+} // namespace
+
+/**
+ * Fill a block of uniformly distributed unit vectors
+ *
+ * Sample i of block b is drawn from Philox counter (i, b_lo, b_hi, 0) under the
+ * seed key, so every block is an independent, reproducible stream.
+ *
+ * @param seed Stream seed
+ * @param block Block index
+ * @param x, y, z Output unit vector components
+ */
+template<typename Float>
+void sample_block(std::uint64_t const seed, std::uint64_t const block, std::span<Float> x, std::span<Float> y,
+    std::span<Float> z)
+{
+    philox4x32::key_type const key = philox4x32::make_key(seed);
+    std::uint32_t const block_lo = static_cast<std::uint32_t>(block);
+    std::uint32_t const block_hi = static_cast<std::uint32_t>(block >> 32);
+
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        auto const bits = philox4x32::generate({ static_cast<std::uint32_t>(i), block_lo, block_hi, 0 }, key);
+        uniform_sphere(uniform_from_bits<Float>(bits[0], bits[1]), uniform_from_bits<Float>(bits[2], bits[3]),
+            x[i], y[i], z[i]);
+    }
+}
+
+/**
+ * Integrate a function with uniform random directions on multiple threads
+ *
+ * The result is bit-identical for a given (id, samples, seed) regardless of the
+ * number of threads.
+ *
+ * @param id The identifier of the function
+ * @param samples Number of samples
+ * @param seed Stream seed
+ * @param threads Worker threads, 0 for hardware concurrency
+ * @return Estimate, its variance and the achieved throughput
+ */
+template<typename Float>
+result<Float> integrate(FunctionId const id, std::size_t const samples, std::uint64_t const seed = 0,
+    unsigned threads = 0)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    std::size_t const blocks = (samples + block_size - 1) / block_size;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(blocks, 1)));
+
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+    std::vector<block_moments> moments(blocks);
+    std::atomic<std::size_t> next = 0;
+
+    auto worker = [&]()
+    {
+        std::vector<Float> x(block_size), y(block_size), z(block_size), values(block_size);
+        for (std::size_t b = next++; b < blocks; b = next++)
+        {
+            std::size_t const n = std::min(block_size, samples - b * block_size);
+            sample_block<Float>(seed, b, { x.data(), n }, { y.data(), n }, { z.data(), n });
+            fn({ x.data(), n }, { y.data(), n }, { z.data(), n }, { values.data(), n });
+
+            block_moments m;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double const v = static_cast<double>(values[i]);
+                ++m.count;
+                double const delta = v - m.mean;
+                m.mean += delta / static_cast<double>(m.count);
+                m.m2 += delta * (v - m.mean);
+            }
+            moments[b] = m;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    block_moments total;
+    for (block_moments const& m : moments)
+        merge(total, m);
+
+    double const area = 4.0 * std::numbers::pi;
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double const sample_variance = total.count > 1 ? total.m2 / static_cast<double>(total.count - 1) : 0.0;
+
+    return {
+        static_cast<Float>(area * total.mean),
+        static_cast<Float>(area * area * sample_variance / static_cast<double>(std::max<std::size_t>(total.count, 1))),
+        total.count,
+        seconds > 0.0 ? static_cast<double>(total.count) / seconds : 0.0
+    };
+}
+
+} // namespace montecarlo
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_MONTECARLO_H
@@ -0,0 +1,393 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_OPTIMIZE_H
+#define SPHERICAL_COLLECTION_OPTIMIZE_H
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include "qmc.h"
+#include "autodiff.h"
+#include "parallel.h"
+#include "functions.h"
+
+namespace sphc
+{
+
+/**
+ * Global maxima and minima of the functions
+ *
+ * A dense scan of Sobol points through the batch evaluator finds the best
+ * seeds, one per basin: seeds closer than a few point spacings to a better
+ * one are skipped. Each seed is refined by Newton's method on the sphere
+ * with the surface gradient and Hessian of autodiff, in the tangent plane
+ * and retracted by normalization, falling back to steepest descent where the
+ * Hessian is indefinite. A compass search finishes every start, which
+ * settles the extremes on kinks and jumps that Newton cannot see.
+ *
+ * At a smooth extreme the value is exact to rounding, as the error is
+ * quadratic in the position; bounds::enclose_maximum and enclose_minimum
+ * certify it, and tools/reference computes the maximums and minimums tables
+ * with it.
+ */
+namespace optimize
+{
+
+enum class goal : std::uint8_t
+{
+    maximum,
+    minimum
+};
+
+struct options
+{
+    std::uint32_t seeds = 1u << 20;     // points of the scan
+    std::size_t starts = 16;            // seeds refined locally
+    std::size_t max_iterations = 100;   // Newton iterations per start
+    unsigned threads = 0;               // 0 for hardware concurrency
+};
+
+template<typename Float>
+struct extremum
+{
+    Float value;
+    Float x, y, z;                  // where the value is attained
+    Float gradient_norm;            // surface gradient there: zero at a smooth extreme, NaN at a singular pole
+    std::size_t evaluations;        // scan, Newton and compass evaluations
+};
+
+namespace
+{
+
+template<typename Float>
+using point = std::array<Float, 3>;
+
+template<typename Float>
+struct candidate
+{
+    Float objective;                // value to minimize, negated for maxima
+    point<Float> p;
+};
+
+template<typename Float>
+bool better(candidate<Float> const& l, candidate<Float> const& r)
+{
+    return l.objective < r.objective;
+}
+
+template<typename Float>
+point<Float> normalized(point<Float> const& p)
+{
+    Float const len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    return { p[0] / len, p[1] / len, p[2] / len };
+}
+
+// orthonormal tangent basis at p, from the axis least aligned with it
+template<typename Float>
+void tangent_basis(point<Float> const& p, point<Float>& e1, point<Float>& e2)
+{
+    std::size_t const k = std::abs(p[0]) < std::abs(p[1]) ? (std::abs(p[0]) < std::abs(p[2]) ? 0 : 2) :
+        (std::abs(p[1]) < std::abs(p[2]) ? 1 : 2);
+    point<Float> axis{};
+    axis[k] = 1;
+    e1 = normalized<Float>({ axis[1] * p[2] - axis[2] * p[1], axis[2] * p[0] - axis[0] * p[2],
+        axis[0] * p[1] - axis[1] * p[0] });
+    e2 = { p[1] * e1[2] - p[2] * e1[1], p[2] * e1[0] - p[0] * e1[2], p[0] * e1[1] - p[1] * e1[0] };
+}
+
+template<typename Float>
+point<Float> retract(point<Float> const& p, point<Float> const& e1, point<Float> const& e2, Float const a,
+    Float const b)
+{
+    return normalized<Float>({ p[0] + a * e1[0] + b * e2[0], p[1] + a * e1[1] + b * e2[1],
+        p[2] + a * e1[2] + b * e2[2] });
+}
+
+/**
+ * Best distinct seeds of a Sobol scan
+ *
+ * Blocks of points are evaluated in parallel, each keeping its best points;
+ * the merged list is then thinned to seeds at least `separation` apart.
+ */
+template<typename Float>
+std::vector<candidate<Float>> scan(FunctionId const id, Float const sign, options const& opt, Float const separation)
+{
+    std::size_t constexpr block = 4096;
+    std::size_t const keep = std::min<std::size_t>(block, 8 * opt.starts);
+    std::size_t const blocks = (opt.seeds + block - 1) / block;
+
+    // the points are generated in double, which qmc supports for any map
+    qmc::sampler<double> sampler;
+    sampler.map = qmc::mapping::octahedral;
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+
+    std::vector<candidate<Float>> kept(blocks * keep, { std::numeric_limits<Float>::infinity(), {} });
+    parallel_for(blocks, opt.threads, false, [&](std::size_t const b, unsigned)
+    {
+        std::size_t const first = b * block;
+        std::size_t const count = std::min<std::size_t>(block, opt.seeds - first);
+        std::vector<double> px(count), py(count), pz(count);
+        sampler.generate(static_cast<std::uint32_t>(first), px, py, pz);
+        std::vector<Float> x(px.begin(), px.end()), y(py.begin(), py.end()), z(pz.begin(), pz.end());
+        std::vector<Float> values(count);
+        fn(x, y, z, values);
+
+        std::vector<candidate<Float>> local(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Float const objective = sign * values[i];
+            local[i] = { objective == objective ? objective : std::numeric_limits<Float>::infinity(),
+                { x[i], y[i], z[i] } };
+        }
+        std::size_t const n = std::min(keep, count);
+        std::partial_sort(local.begin(), local.begin() + n, local.end(), better<Float>);
+        std::copy(local.begin(), local.begin() + n, kept.begin() + b * keep);
+    });
+    std::sort(kept.begin(), kept.end(), better<Float>);
+
+    std::vector<candidate<Float>> seeds;
+    Float const chord = separation * separation;
+    for (candidate<Float> const& c : kept)
+    {
+        if (seeds.size() == opt.starts || c.objective == std::numeric_limits<Float>::infinity())
+            break;
+        bool const distinct = std::none_of(seeds.begin(), seeds.end(), [&](candidate<Float> const& s)
+        {
+            Float const dx = s.p[0] - c.p[0], dy = s.p[1] - c.p[1], dz = s.p[2] - c.p[2];
+            return dx * dx + dy * dy + dz * dz < chord;
+        });
+        if (distinct)
+            seeds.push_back(c);
+    }
+    return seeds;
+}
+
+/**
+ * Newton's method on the sphere followed by a compass search
+ *
+ * @param radius Largest step, about the spacing of the scan
+ */
+template<typename Float>
+candidate<Float> refine(FunctionId const id, Float const sign, candidate<Float> start, Float const radius,
+    std::size_t const max_iterations, std::size_t& evaluations)
+{
+    function_xyz<Float> const f = get_function_xyz<Float>(id);
+    auto objective = [&](point<Float> const& p)
+    {
+        ++evaluations;
+        Float const v = sign * f(p[0], p[1], p[2]);
+        return v == v ? v : std::numeric_limits<Float>::infinity();
+    };
+
+    candidate<Float> c = start;
+    point<Float> e1, e2;
+    for (std::size_t iteration = 0; iteration < max_iterations; ++iteration)
+    {
+        ++evaluations;
+        autodiff::derivatives<Float> const d = autodiff::differentiate<Float>(id, c.p[0], c.p[1], c.p[2], true);
+        tangent_basis(c.p, e1, e2);
+
+        // gradient and Hessian of the objective in the basis (e1, e2)
+        auto form = [&](point<Float> const& u, point<Float> const& v)
+        {
+            std::array<Float, 6> const& h = d.hessian;
+            return sign * (u[0] * (h[0] * v[0] + h[1] * v[1] + h[2] * v[2]) +
+                u[1] * (h[1] * v[0] + h[3] * v[1] + h[4] * v[2]) +
+                u[2] * (h[2] * v[0] + h[4] * v[1] + h[5] * v[2]));
+        };
+        Float const g1 = sign * (d.gradient[0] * e1[0] + d.gradient[1] * e1[1] + d.gradient[2] * e1[2]);
+        Float const g2 = sign * (d.gradient[0] * e2[0] + d.gradient[1] * e2[1] + d.gradient[2] * e2[2]);
+        Float const h11 = form(e1, e1), h12 = form(e1, e2), h22 = form(e2, e2);
+        Float const det = h11 * h22 - h12 * h12;
+        if (!std::isfinite(g1) || !std::isfinite(g2) || !std::isfinite(det))
+            break;
+
+        Float a, b;
+        if (h11 > 0 && det > 0)
+        {
+            a = -(h22 * g1 - h12 * g2) / det;
+            b = -(h11 * g2 - h12 * g1) / det;
+        }
+        else
+        {
+            a = -g1;
+            b = -g2;
+        }
+        Float const length = std::hypot(a, b);
+        if (!(length > 0))
+            break;
+        if (length > radius)
+        {
+            a *= radius / length;
+            b *= radius / length;
+        }
+
+        // backtracking until the objective decreases
+        bool accepted = false;
+        for (Float t = 1; t > 1e-12; t /= 2)
+        {
+            point<Float> const q = retract(c.p, e1, e2, t * a, t * b);
+            Float const v = objective(q);
+            if (v < c.objective)
+            {
+                c = { v, q };
+                accepted = true;
+                break;
+            }
+        }
+        if (!accepted)
+            break;
+    }
+
+    // compass search in the tangent plane, down to rounding of the position
+    Float constexpr directions[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 },
+        { -1, 1 } };
+    for (Float step = radius; step > 4 * std::numeric_limits<Float>::epsilon();)
+    {
+        tangent_basis(c.p, e1, e2);
+        bool improved = false;
+        for (auto const& dir : directions)
+        {
+            point<Float> const q = retract(c.p, e1, e2, step * dir[0], step * dir[1]);
+            Float const v = objective(q);
+            if (v < c.objective)
+            {
+                c = { v, q };
+                improved = true;
+                break;
+            }
+        }
+        if (!improved)
+            step /= 2;
+    }
+    return c;
+}
+
+inline void validate(options const& opt)
+{
+    if (opt.seeds == 0 || opt.starts == 0)
+        throw std::invalid_argument("optimization needs at least one seed and one start");
+}
+
+template<typename Float>
+extremum<Float> find_extremum(FunctionId const id, goal const g, options const& opt)
+{
+    Float const sign = g == goal::maximum ? -1 : 1;
+    Float const spacing = std::sqrt(4 * std::numbers::pi_v<Float> / static_cast<Float>(opt.seeds));
+
+    std::vector<candidate<Float>> const seeds = scan<Float>(id, sign, opt, 4 * spacing);
+    if (seeds.empty())
+        throw std::invalid_argument("function has no finite values to optimize");
+    std::vector<candidate<Float>> refined(seeds.size());
+    std::vector<std::size_t> evaluations(seeds.size(), 0);
+    parallel_for(seeds.size(), opt.threads, false, [&](std::size_t const i, unsigned)
+    {
+        refined[i] = refine<Float>(id, sign, seeds[i], 2 * spacing, opt.max_iterations, evaluations[i]);
+    });
+
+    candidate<Float> const best = *std::min_element(refined.begin(), refined.end(), better<Float>);
+    autodiff::derivatives<Float> const d = autodiff::differentiate<Float>(id, best.p[0], best.p[1], best.p[2]);
+    std::size_t total = opt.seeds + 1;
+    for (std::size_t const e : evaluations)
+        total += e;
+    return { sign * best.objective, best.p[0], best.p[1], best.p[2],
+        std::hypot(d.gradient[0], d.gradient[1], d.gradient[2]), total };
+}
+
+} // namespace
+
+/**
+ * Global maximum of a function and where it is attained
+ *
+ * @param id The identifier of the function
+ * @param opt Scan size, starts and threads
+ * @return The maximum, its location and the surface gradient there
+ * @throws std::invalid_argument if opt has no seeds or starts, or the scan
+ *         finds no finite value
+ */
+template<typename Float>
+extremum<Float> find_maximum(FunctionId const id, options const& opt = {})
+{
+    validate(opt);
+    return find_extremum<Float>(id, goal::maximum, opt);
+}
+
+template<typename Float>
+extremum<Float> find_maximum(std::string_view const id, options const& opt = {})
+{
+    return find_maximum<Float>(function_id(id), opt);
+}
+
+/**
+ * Global minimum of a function and where it is attained, see find_maximum
+ */
+template<typename Float>
+extremum<Float> find_minimum(FunctionId const id, options const& opt = {})
+{
+    validate(opt);
+    return find_extremum<Float>(id, goal::minimum, opt);
+}
+
+template<typename Float>
+extremum<Float> find_minimum(std::string_view const id, options const& opt = {})
+{
+    return find_minimum<Float>(function_id(id), opt);
+}
+
+/**
+ * Extremes of every function, in parallel over the functions
+ *
+ * @param g Maxima or minima
+ * @param opt Scan size and starts of every function; threads is the size of
+ *        the pool shared by the functions
+ * @return The extremes indexed by FunctionId, in the layout of the tables
+ * @throws std::invalid_argument as find_maximum, after all functions finish
+ */
+template<typename Float>
+std::array<extremum<Float>, function_count> find_all(goal const g, options const& opt = {})
+{
+    validate(opt);
+    options single = opt;
+    single.threads = 1;
+
+    // the workers cannot throw, their errors are rethrown here
+    std::array<extremum<Float>, function_count> out;
+    std::array<std::exception_ptr, function_count> errors;
+    parallel_for(function_count, opt.threads, false, [&](std::size_t const i, unsigned)
+    {
+        try
+        {
+            out[i] = find_extremum<Float>(static_cast<FunctionId>(i), g, single);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    });
+    for (std::exception_ptr const& e : errors)
+    {
+        if (e)
+            std::rethrow_exception(e);
+    }
+    return out;
+}
+
+} // namespace optimize
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_OPTIMIZE_H
@@ -0,0 +1,149 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_PARALLEL_H
+#define SPHERICAL_COLLECTION_PARALLEL_H
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sphc
+{
+
+struct schedule_stats
+{
+    unsigned threads;           // workers that ran
+    std::size_t steals;         // successful steals
+};
+
+namespace
+{
+
+// items [begin, end) still owned by a worker
+struct alignas(64) work_range
+{
+    std::mutex lock;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+inline bool pop_front(work_range& r, std::size_t& item)
+{
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (r.begin == r.end)
+        return false;
+    item = r.begin++;
+    return true;
+}
+
+// take the upper half of a victim's remaining items, at least one
+inline bool steal_back(work_range& victim, std::size_t& begin, std::size_t& end)
+{
+    std::lock_guard<std::mutex> guard(victim.lock);
+    std::size_t const remaining = victim.end - victim.begin;
+    if (remaining == 0)
+        return false;
+    begin = victim.end - (remaining + 1) / 2;
+    end = victim.end;
+    victim.end = begin;
+    return true;
+}
+
+inline void pin_to_cpu([[maybe_unused]] unsigned const cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+} // namespace
+
+/**
+ * Run body(item, worker) for every item in [0, count) on a work-stealing pool
+ *
+ * Each worker starts with a contiguous block of items, so neighbouring items
+ * (and the memory they first touch) stay on one worker; a worker that runs out
+ * steals the upper half of another worker's remaining block.
+ *
+ * @param count Number of items
+ * @param threads Worker threads, 0 for hardware concurrency
+ * @param pin Pin worker w to CPU w (Linux only), which keeps first-touch
+ *        allocated memory on the NUMA node of the worker that wrote it
+ * @param body Callable taking (std::size_t item, unsigned worker)
+ */
+template<typename Body>
+schedule_stats parallel_for(std::size_t const count, unsigned threads, bool const pin, Body&& body)
+{
+    unsigned const hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 0)
+        threads = hardware;
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(count, 1)));
+
+    std::unique_ptr<work_range[]> ranges(new work_range[threads]);
+    for (unsigned w = 0; w < threads; ++w)
+    {
+        ranges[w].begin = count * w / threads;
+        ranges[w].end = count * (w + 1) / threads;
+    }
+
+    std::atomic<std::size_t> steals = 0;
+    auto worker = [&](unsigned const w)
+    {
+        if (pin)
+            pin_to_cpu(w % hardware);
+
+        for (;;)
+        {
+            std::size_t item;
+            while (pop_front(ranges[w], item))
+                body(item, w);
+
+            bool stolen = false;
+            for (unsigned k = 1; k < threads && !stolen; ++k)
+            {
+                std::size_t begin, end;
+                if (steal_back(ranges[(w + k) % threads], begin, end))
+                {
+                    std::lock_guard<std::mutex> guard(ranges[w].lock);
+                    ranges[w].begin = begin;
+                    ranges[w].end = end;
+                    stolen = true;
+                }
+            }
+            if (!stolen)
+                return;
+            ++steals;
+        }
+    };
+
+    // pinned workers all get their own thread, the caller keeps its affinity
+    std::vector<std::thread> pool;
+    for (unsigned w = pin ? 0 : 1; w < threads; ++w)
+        pool.emplace_back(worker, w);
+    if (!pin)
+        worker(0);
+    for (std::thread& t : pool)
+        t.join();
+
+    return { threads, steals.load() };
+}
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_PARALLEL_H
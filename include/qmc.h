@@ -0,0 +1,317 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_QMC_H
+#define SPHERICAL_COLLECTION_QMC_H
+
+#include <span>
+#include <cmath>
+#include <vector>
+#include <numbers>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "functions.h"
+#include "random.h"
+#include "vmath.h"
+
+namespace sphc
+{
+
+/**
+ * Quasi-Monte Carlo point sets on the sphere
+ *
+ * Points are computed directly from their index with fixed-length integer loops
+ * and no branches, so any range [first, first + n) can be produced in
+ * independent blocks and the loops vectorize.
+ */
+namespace qmc
+{
+
+enum class sequence : std::uint8_t
+{
+    sobol,      // first two Sobol dimensions, base 2
+    halton,     // bases 2 and 3
+    lattice     // rank-1 lattice (1, g) / n
+};
+
+/**
+ * Equal-area maps from the unit square to the sphere
+ */
+enum class mapping : std::uint8_t
+{
+    lambert,    // cylindrical: z = 1 - 2u, phi = 2 pi v
+    octahedral  // Clarberg's octahedral map, lower distortion near the poles
+};
+
+namespace
+{
+
+inline std::uint32_t reverse_bits(std::uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+inline std::uint32_t hash32(std::uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Owen scrambling of a base-2 fraction via the Laine-Karras hash (Burley 2020)
+inline std::uint32_t owen_scramble_base2(std::uint32_t x, std::uint32_t const seed)
+{
+    x = reverse_bits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse_bits(x);
+}
+
+// Second Sobol dimension, primitive polynomial x + 1
+inline std::uint32_t sobol_dim1(std::uint32_t const i)
+{
+    std::uint32_t v = 0x80000000u;
+    std::uint32_t r = 0;
+    for (int j = 0; j < 32; ++j)
+    {
+        r ^= v & (0u - ((i >> j) & 1u));
+        v ^= v >> 1;
+    }
+    return r;
+}
+
+inline constexpr int base3_digits = 20;
+inline constexpr std::uint64_t base3_scale = 3486784401ull;    // 3^20
+
+// Base-3 radical inverse; with scrambling each digit is permuted by one of the
+// six permutations of {0, 1, 2}, chosen by hashing the digits below it, which
+// is nested uniform (Owen) scrambling
+inline std::uint64_t radical_inverse_base3(std::uint32_t i, bool const scramble, std::uint32_t const seed)
+{
+    std::uint64_t inv = 0;
+    std::uint32_t prefix = 0;
+    std::uint32_t power = 1;
+    for (int k = 0; k < base3_digits; ++k)
+    {
+        std::uint32_t d = i % 3u;
+        i /= 3u;
+
+        std::uint32_t const h = hash32(prefix ^ hash32(seed + static_cast<std::uint32_t>(k) * 0x9E3779B9u)) % 6u;
+        std::uint32_t const shifted = (d + h % 3u) % 3u;
+        std::uint32_t const permuted = h < 3u ? shifted : 2u - shifted;
+
+        prefix += d * power;
+        power *= 3u;
+        d = scramble ? permuted : d;
+        inv = inv * 3u + d;
+    }
+    return inv;
+}
+
+} // namespace
+
+/**
+ * Map a point of the unit square to the sphere
+ */
+template<typename Float>
+void square_to_sphere(mapping const map, Float const u, Float const v, Float& x, Float& y, Float& z)
+{
+    if (map == mapping::lambert)
+    {
+        uniform_sphere(u, v, x, y, z);
+        return;
+    }
+
+    Float const su = Float(2) * u - Float(1);
+    Float const sv = Float(2) * v - Float(1);
+    Float const au = std::abs(su);
+    Float const av = std::abs(sv);
+    Float const signed_distance = Float(1) - (au + av);
+    Float const r = Float(1) - std::abs(signed_distance);
+    Float const phi = (r == Float(0) ? Float(1) : (av - au) / r + Float(1)) * std::numbers::pi_v<Float> / Float(4);
+
+    Float s, c;
+    vmath::sincos(phi, s, c);
+    Float const scale = r * vmath::sqrt(Float(2) - r * r);
+    x = std::copysign(c, su) * scale;
+    y = std::copysign(s, sv) * scale;
+    z = std::copysign(Float(1) - r * r, signed_distance);
+}
+
+/**
+ * Point set description
+ *
+ * For lattices, lattice_points is the lattice size n (required) and
+ * lattice_generator the generating vector component g; 0 selects the
+ * Fibonacci-like default round(n / golden ratio). Scrambling is Owen
+ * scrambling for Sobol and Halton and a random shift modulo 1 for lattices.
+ */
+template<typename Float>
+struct sampler
+{
+    sequence seq = sequence::sobol;
+    mapping map = mapping::lambert;
+    bool scrambled = false;
+    std::uint32_t seed = 0;
+    std::uint32_t lattice_points = 0;
+    std::uint32_t lattice_generator = 0;
+
+    /**
+     * Points [first, first + u.size()) in the unit square
+     */
+    void unit_square(std::uint32_t const first, std::span<Float> u, std::span<Float> v) const
+    {
+        assert(v.size() == u.size());
+
+        std::uint32_t const seed_u = hash32(seed);
+        std::uint32_t const seed_v = hash32(seed ^ 0x5bd1e995u);
+        std::size_t const n = u.size();
+
+        switch (seq)
+        {
+            case sequence::sobol:
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    std::uint32_t const i = first + static_cast<std::uint32_t>(k);
+                    std::uint32_t const a = reverse_bits(i);
+                    std::uint32_t const b = sobol_dim1(i);
+                    u[k] = uniform_from_bits<Float>(scrambled ? owen_scramble_base2(a, seed_u) : a);
+                    v[k] = uniform_from_bits<Float>(scrambled ? owen_scramble_base2(b, seed_v) : b);
+                }
+                break;
+            case sequence::halton:
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    std::uint32_t const i = first + static_cast<std::uint32_t>(k);
+                    std::uint32_t const a = reverse_bits(i);
+                    std::uint64_t const b = radical_inverse_base3(i, scrambled, seed_v);
+                    u[k] = uniform_from_bits<Float>(scrambled ? owen_scramble_base2(a, seed_u) : a);
+                    v[k] = static_cast<Float>(static_cast<double>(b) / static_cast<double>(base3_scale));
+                }
+                break;
+            case sequence::lattice:
+            {
+                assert(lattice_points > 0);
+                std::uint64_t const points = lattice_points;
+                std::uint64_t const g = lattice_generator != 0 ? lattice_generator :
+                    static_cast<std::uint64_t>(std::llround(static_cast<double>(points) / std::numbers::phi));
+                double const shift_u = scrambled ? uniform_from_bits<double>(seed_u) : 0.0;
+                double const shift_v = scrambled ? uniform_from_bits<double>(seed_v) : 0.0;
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    std::uint64_t const i = first + k;
+                    double const a = static_cast<double>(i % points) / static_cast<double>(points) + shift_u;
+                    double const b = static_cast<double>((i * g) % points) / static_cast<double>(points) + shift_v;
+                    u[k] = static_cast<Float>(a - std::floor(a));
+                    v[k] = static_cast<Float>(b - std::floor(b));
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+     * Points [first, first + x.size()) on the sphere, as unit vectors
+     */
+    void generate(std::uint32_t const first, std::span<Float> x, std::span<Float> y, std::span<Float> z) const
+    {
+        assert(y.size() == x.size() && z.size() == x.size());
+
+        // the unit square coordinates are staged in the y and z outputs
+        unit_square(first, y, z);
+        for (std::size_t k = 0; k < x.size(); ++k)
+            square_to_sphere(map, y[k], z[k], x[k], y[k], z[k]);
+    }
+};
+
+/**
+ * Integrate a function with the first n points of a sampler
+ *
+ * @param s Point set
+ * @param id The identifier of the function
+ * @param n Number of points
+ * @return Surface integral estimate
+ */
+template<typename Float>
+Float integrate(sampler<Float> const& s, FunctionId const id, std::uint32_t const n)
+{
+    std::size_t constexpr block = 4096;
+    std::vector<Float> x(block), y(block), z(block), values(block);
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+
+    double sum = 0.0;
+    // 64-bit, as the last block would wrap a 32-bit counter for n close to 2^32
+    for (std::uint64_t first = 0; first < n; first += block)
+    {
+        std::size_t const count = static_cast<std::size_t>(std::min<std::uint64_t>(block, n - first));
+        s.generate(static_cast<std::uint32_t>(first), { x.data(), count }, { y.data(), count }, { z.data(), count });
+        fn({ x.data(), count }, { y.data(), count }, { z.data(), count }, { values.data(), count });
+        for (std::size_t i = 0; i < count; ++i)
+            sum += static_cast<double>(values[i]);
+    }
+    return static_cast<Float>(4.0 * std::numbers::pi * sum / static_cast<double>(n));
+}
+
+template<typename Float>
+struct rqmc_result
+{
+    Float estimate;     // mean over the replicas
+    Float std_error;    // standard error of the mean over the replicas
+};
+
+/**
+ * Randomized QMC: integrate with independently scrambled replicas of a sampler
+ *
+ * @param s Point set, its seed selects the replica family
+ * @param id The identifier of the function
+ * @param n Number of points per replica
+ * @param replicas Number of independent scramblings, at least 2
+ * @throws std::invalid_argument if replicas is less than 2
+ */
+template<typename Float>
+rqmc_result<Float> integrate_randomized(sampler<Float> s, FunctionId const id, std::uint32_t const n,
+    std::uint32_t const replicas)
+{
+    if (replicas < 2)
+        throw std::invalid_argument("randomized integration needs at least two replicas");
+
+    std::uint32_t const base_seed = s.seed;
+    s.scrambled = true;
+
+    double mean = 0.0;
+    double m2 = 0.0;
+    for (std::uint32_t r = 0; r < replicas; ++r)
+    {
+        s.seed = hash32(base_seed + r);
+        double const v = static_cast<double>(integrate(s, id, n));
+        double const delta = v - mean;
+        mean += delta / static_cast<double>(r + 1);
+        m2 += delta * (v - mean);
+    }
+
+    double const variance = m2 / static_cast<double>(replicas - 1);
+    return { static_cast<Float>(mean), static_cast<Float>(std::sqrt(variance / static_cast<double>(replicas))) };
+}
+
+} // namespace qmc
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_QMC_H
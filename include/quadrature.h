@@ -0,0 +1,446 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_QUADRATURE_H
+#define SPHERICAL_COLLECTION_QUADRATURE_H
+
+#include <map>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <numbers>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "functions.h"
+
+namespace sphc
+{
+
+/**
+ * Quadrature rules on the unit sphere
+ */
+namespace quadrature
+{
+
+/**
+ * Supported rule families
+ *
+ * The meaning of the order parameter depends on the family:
+ *  - lebedev: number of points (6, 14, 26, 38 or 50)
+ *  - fibonacci: number of points
+ *  - healpix: resolution Nside, giving 12 * Nside^2 points
+ *  - gauss_product: Gauss-Legendre nodes in cos(theta), with 2n trapezoid nodes in phi
+ *  - icosahedral: subdivision level, giving 20 * 4^level points
+ */
+enum class rule_type : std::uint8_t
+{
+    lebedev,
+    fibonacci,
+    healpix,
+    gauss_product,
+    icosahedral
+};
+
+/**
+ * Nodes on the unit sphere and their weights, stored as structure-of-arrays
+ * so they feed the batch evaluators directly
+ */
+template<typename Float>
+struct rule
+{
+    std::vector<Float> x;
+    std::vector<Float> y;
+    std::vector<Float> z;
+    std::vector<Float> weight;
+
+    std::size_t size() const { return weight.size(); }
+
+    void add(double const px, double const py, double const pz, double const w)
+    {
+        x.push_back(static_cast<Float>(px));
+        y.push_back(static_cast<Float>(py));
+        z.push_back(static_cast<Float>(pz));
+        weight.push_back(static_cast<Float>(w));
+    }
+};
+
+namespace
+{
+
+template<typename Float>
+void add_spherical(rule<Float>& r, double const cos_theta, double const phi, double const w)
+{
+    double const sin_theta = std::sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+    r.add(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta, w);
+}
+
+// Lebedev octahedral orbits: all sign changes and permutations of a generator
+template<typename Float>
+void add_orbit(rule<Float>& r, int const code, double const a, double const w)
+{
+    double const w4pi = 4.0 * std::numbers::pi * w;
+    switch (code)
+    {
+        case 1: // (1, 0, 0)
+            for (double const s : { -1.0, 1.0 })
+            {
+                r.add(s, 0, 0, w4pi);
+                r.add(0, s, 0, w4pi);
+                r.add(0, 0, s, w4pi);
+            }
+            break;
+        case 2: // (0, a, a), a = 1 / sqrt(2)
+        {
+            double const v = 1.0 / std::numbers::sqrt2;
+            for (double const s1 : { -v, v })
+                for (double const s2 : { -v, v })
+                {
+                    r.add(0, s1, s2, w4pi);
+                    r.add(s1, 0, s2, w4pi);
+                    r.add(s1, s2, 0, w4pi);
+                }
+            break;
+        }
+        case 3: // (a, a, a), a = 1 / sqrt(3)
+        {
+            double const v = 1.0 / std::numbers::sqrt3;
+            for (double const s1 : { -v, v })
+                for (double const s2 : { -v, v })
+                    for (double const s3 : { -v, v })
+                        r.add(s1, s2, s3, w4pi);
+            break;
+        }
+        case 4: // (a, a, b), b = sqrt(1 - 2a^2)
+        {
+            double const b = std::sqrt(1.0 - 2.0 * a * a);
+            for (double const s1 : { -a, a })
+                for (double const s2 : { -a, a })
+                    for (double const s3 : { -b, b })
+                    {
+                        r.add(s1, s2, s3, w4pi);
+                        r.add(s1, s3, s2, w4pi);
+                        r.add(s3, s1, s2, w4pi);
+                    }
+            break;
+        }
+        case 5: // (a, b, 0), b = sqrt(1 - a^2)
+        {
+            double const b = std::sqrt(1.0 - a * a);
+            for (double const s1 : { -a, a })
+                for (double const s2 : { -b, b })
+                {
+                    r.add(s1, s2, 0, w4pi);
+                    r.add(s2, s1, 0, w4pi);
+                    r.add(s1, 0, s2, w4pi);
+                    r.add(s2, 0, s1, w4pi);
+                    r.add(0, s1, s2, w4pi);
+                    r.add(0, s2, s1, w4pi);
+                }
+            break;
+        }
+        default:
+            throw std::invalid_argument("unknown Lebedev orbit");
+    }
+}
+
+template<typename Float>
+void build_lebedev(rule<Float>& r, std::size_t const points)
+{
+    switch (points)
+    {
+        case 6:
+            add_orbit(r, 1, 0.0, 1.0 / 6.0);
+            break;
+        case 14:
+            add_orbit(r, 1, 0.0, 1.0 / 15.0);
+            add_orbit(r, 3, 0.0, 3.0 / 40.0);
+            break;
+        case 26:
+            add_orbit(r, 1, 0.0, 1.0 / 21.0);
+            add_orbit(r, 2, 0.0, 4.0 / 105.0);
+            add_orbit(r, 3, 0.0, 9.0 / 280.0);
+            break;
+        case 38:
+            add_orbit(r, 1, 0.0, 1.0 / 105.0);
+            add_orbit(r, 3, 0.0, 9.0 / 280.0);
+            add_orbit(r, 5, 0.4597008433809831, 1.0 / 35.0);
+            break;
+        case 50:
+            add_orbit(r, 1, 0.0, 4.0 / 315.0);
+            add_orbit(r, 2, 0.0, 64.0 / 2835.0);
+            add_orbit(r, 3, 0.0, 27.0 / 1280.0);
+            add_orbit(r, 4, 1.0 / std::sqrt(11.0), 14641.0 / 725760.0);
+            break;
+        default:
+            throw std::invalid_argument("unsupported Lebedev rule size");
+    }
+}
+
+template<typename Float>
+void build_fibonacci(rule<Float>& r, std::size_t const n)
+{
+    double const golden_angle = 2.0 * std::numbers::pi * (2.0 - std::numbers::phi);
+    double const w = 4.0 * std::numbers::pi / static_cast<double>(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double const z = 1.0 - (2.0 * static_cast<double>(i) + 1.0) / static_cast<double>(n);
+        add_spherical(r, z, golden_angle * static_cast<double>(i), w);
+    }
+}
+
+template<typename Float>
+void build_healpix(rule<Float>& r, std::size_t const nside)
+{
+    double const ns = static_cast<double>(nside);
+    double const w = 4.0 * std::numbers::pi / (12.0 * ns * ns);
+
+    for (std::size_t ring = 1; ring < 4 * nside; ++ring)
+    {
+        double const i = static_cast<double>(ring);
+        if (ring < nside || ring > 3 * nside)
+        {
+            // polar caps, the south one mirrors the north one
+            double const k = ring < nside ? i : 4.0 * ns - i;
+            double const z = 1.0 - k * k / (3.0 * ns * ns);
+            std::size_t const count = 4 * static_cast<std::size_t>(k);
+            for (std::size_t j = 1; j <= count; ++j)
+                add_spherical(r, ring < nside ? z : -z, std::numbers::pi / (2.0 * k) * (static_cast<double>(j) - 0.5), w);
+        }
+        else
+        {
+            double const z = 4.0 / 3.0 - 2.0 * i / (3.0 * ns);
+            double const shift = static_cast<double>((ring - nside + 1) % 2);
+            for (std::size_t j = 1; j <= 4 * nside; ++j)
+                add_spherical(r, z, std::numbers::pi / (2.0 * ns) * (static_cast<double>(j) - 0.5 * shift), w);
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * Gauss-Legendre nodes and weights on [-1, 1]
+ *
+ * @param n Number of nodes
+ * @param nodes Output nodes, ascending
+ * @param weights Output weights
+ */
+inline void gauss_legendre(std::size_t const n, std::vector<double>& nodes, std::vector<double>& weights)
+{
+    nodes.assign(n, 0.0);
+    weights.assign(n, 0.0);
+
+    for (std::size_t i = 0; i < (n + 1) / 2; ++i)
+    {
+        double x = std::cos(std::numbers::pi * (static_cast<double>(i) + 0.75) / (static_cast<double>(n) + 0.5));
+        double dp = 0.0;
+        for (int iter = 0; iter < 100; ++iter)
+        {
+            double p0 = 1.0, p1 = x;
+            for (std::size_t k = 2; k <= n; ++k)
+            {
+                double const p2 = ((2.0 * k - 1.0) * x * p1 - (k - 1.0) * p0) / static_cast<double>(k);
+                p0 = p1;
+                p1 = p2;
+            }
+            dp = static_cast<double>(n) * (x * p1 - p0) / (x * x - 1.0);
+            double const dx = p1 / dp;
+            x -= dx;
+            if (std::abs(dx) < 1e-16)
+                break;
+        }
+
+        nodes[i] = -x;
+        nodes[n - 1 - i] = x;
+        weights[i] = weights[n - 1 - i] = 2.0 / ((1.0 - x * x) * dp * dp);
+    }
+}
+
+namespace
+{
+
+template<typename Float>
+void build_gauss_product(rule<Float>& r, std::size_t const n)
+{
+    std::vector<double> nodes, weights;
+    gauss_legendre(n, nodes, weights);
+
+    std::size_t const nphi = 2 * n;
+    double const dphi = 2.0 * std::numbers::pi / static_cast<double>(nphi);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < nphi; ++j)
+            add_spherical(r, nodes[i], dphi * static_cast<double>(j), weights[i] * dphi);
+}
+
+using vec3 = std::array<double, 3>;
+
+inline vec3 normalized(vec3 const& v)
+{
+    double const len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    return { v[0] / len, v[1] / len, v[2] / len };
+}
+
+inline vec3 midpoint(vec3 const& a, vec3 const& b)
+{
+    return normalized({ a[0] + b[0], a[1] + b[1], a[2] + b[2] });
+}
+
+// Area of the spherical triangle (Van Oosterom & Strackee)
+inline double spherical_triangle_area(vec3 const& a, vec3 const& b, vec3 const& c)
+{
+    double const triple = a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0]) +
+        a[2] * (b[0] * c[1] - b[1] * c[0]);
+    double const denom = 1.0 + dot(a[0], a[1], a[2], b[0], b[1], b[2]) + dot(b[0], b[1], b[2], c[0], c[1], c[2]) +
+        dot(c[0], c[1], c[2], a[0], a[1], a[2]);
+    return 2.0 * std::atan2(std::abs(triple), denom);
+}
+
+inline void icosahedron(std::vector<vec3>& vertices, std::vector<std::array<std::size_t, 3>>& faces)
+{
+    double const t = std::numbers::phi;
+    vertices = {
+        { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+        { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+        { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 }
+    };
+    for (vec3& v : vertices)
+        v = normalized(v);
+
+    faces = {
+        { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+        { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+        { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+        { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+    };
+}
+
+template<typename Float>
+void add_icosahedral_triangle(rule<Float>& r, vec3 const& a, vec3 const& b, vec3 const& c, std::size_t const level)
+{
+    if (level == 0)
+    {
+        vec3 const centroid = normalized({ a[0] + b[0] + c[0], a[1] + b[1] + c[1], a[2] + b[2] + c[2] });
+        r.add(centroid[0], centroid[1], centroid[2], spherical_triangle_area(a, b, c));
+        return;
+    }
+
+    vec3 const ab = midpoint(a, b);
+    vec3 const bc = midpoint(b, c);
+    vec3 const ca = midpoint(c, a);
+    add_icosahedral_triangle(r, a, ab, ca, level - 1);
+    add_icosahedral_triangle(r, ab, b, bc, level - 1);
+    add_icosahedral_triangle(r, ca, bc, c, level - 1);
+    add_icosahedral_triangle(r, ab, bc, ca, level - 1);
+}
+
+template<typename Float>
+void build_icosahedral(rule<Float>& r, std::size_t const level)
+{
+    std::vector<vec3> vertices;
+    std::vector<std::array<std::size_t, 3>> faces;
+    icosahedron(vertices, faces);
+
+    for (auto const& f : faces)
+        add_icosahedral_triangle(r, vertices[f[0]], vertices[f[1]], vertices[f[2]], level);
+}
+
+} // namespace
+
+/**
+ * Generate a rule without caching
+ *
+ * @param type Rule family
+ * @param order Family-specific order, see rule_type
+ * @return The generated rule
+ * @throws std::invalid_argument for unsupported orders
+ */
+template<typename Float>
+rule<Float> make_rule(rule_type const type, std::size_t const order)
+{
+    if (order == 0)
+        throw std::invalid_argument("quadrature order must be positive");
+
+    rule<Float> r;
+    switch (type)
+    {
+        case rule_type::lebedev:       build_lebedev(r, order); break;
+        case rule_type::fibonacci:     build_fibonacci(r, order); break;
+        case rule_type::healpix:       build_healpix(r, order); break;
+        case rule_type::gauss_product: build_gauss_product(r, order); break;
+        case rule_type::icosahedral:   build_icosahedral(r, order); break;
+    }
+    return r;
+}
+
+/**
+ * Get a cached rule
+ *
+ * Each (type, order) pair is generated once per process and shared, so the
+ * setup cost is amortized across all functions integrated with it.
+ *
+ * @param type Rule family
+ * @param order Family-specific order, see rule_type
+ * @return Shared immutable rule
+ */
+template<typename Float>
+std::shared_ptr<rule<Float> const> get_rule(rule_type const type, std::size_t const order)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<rule_type, std::size_t>, std::shared_ptr<rule<Float> const>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[{ type, order }];
+    if (!entry)
+        entry = std::make_shared<rule<Float> const>(make_rule<Float>(type, order));
+    return entry;
+}
+
+/**
+ * Integrate a function with a rule, evaluating through the batch kernels
+ *
+ * @param r Quadrature rule
+ * @param id The identifier of the function
+ * @return Approximation of the surface integral
+ */
+template<typename Float>
+Float integrate(rule<Float> const& r, FunctionId const id)
+{
+    std::size_t constexpr block = 4096;
+    Float values[block];
+
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+
+    double sum = 0.0;
+    for (std::size_t start = 0; start < r.size(); start += block)
+    {
+        std::size_t const n = std::min(block, r.size() - start);
+        fn({ r.x.data() + start, n }, { r.y.data() + start, n }, { r.z.data() + start, n }, { values, n });
+        for (std::size_t i = 0; i < n; ++i)
+            sum += static_cast<double>(values[i]) * static_cast<double>(r.weight[start + i]);
+    }
+    return static_cast<Float>(sum);
+}
+
+/**
+ * Integrate a function with a cached rule
+ */
+template<typename Float>
+Float integrate(rule_type const type, std::size_t const order, FunctionId const id)
+{
+    return integrate(*get_rule<Float>(type, order), id);
+}
+
+} // namespace quadrature
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_QUADRATURE_H
@@ -0,0 +1,96 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_RANDOM_H
+#define SPHERICAL_COLLECTION_RANDOM_H
+
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <type_traits>
+
+#include "vmath.h"
+
+namespace sphc
+{
+
+/**
+ * Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random
+ * Numbers: As Easy as 1, 2, 3")
+ *
+ * The output is a pure function of (counter, key), so any sample of any stream
+ * can be generated independently and in any order.
+ */
+struct philox4x32
+{
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    static constexpr counter_type generate(counter_type c, key_type k)
+    {
+        for (int round = 0; round < 10; ++round)
+        {
+            std::uint64_t const p0 = std::uint64_t(0xD2511F53u) * c[0];
+            std::uint64_t const p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+            c = {
+                static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+                static_cast<std::uint32_t>(p1),
+                static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+                static_cast<std::uint32_t>(p0)
+            };
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+        return c;
+    }
+
+    static constexpr key_type make_key(std::uint64_t const seed)
+    {
+        return { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+    }
+};
+
+/**
+ * Map 32 random bits to [0, 1)
+ */
+template<typename Float>
+constexpr Float uniform_from_bits(std::uint32_t const bits)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return static_cast<float>(bits >> 8) * 0x1.0p-24f;
+    else
+        return static_cast<Float>(bits) * Float(0x1.0p-32);
+}
+
+/**
+ * Map 64 random bits to [0, 1)
+ */
+template<typename Float>
+constexpr Float uniform_from_bits(std::uint32_t const hi, std::uint32_t const lo)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return uniform_from_bits<float>(hi);
+    else
+        return static_cast<Float>(((std::uint64_t(hi) << 32) | lo) >> 11) * Float(0x1.0p-53);
+}
+
+/**
+ * Map two uniforms in [0, 1) to a uniformly distributed unit vector
+ */
+template<typename Float>
+void uniform_sphere(Float const u, Float const v, Float& x, Float& y, Float& z)
+{
+    z = Float(1) - Float(2) * u;
+    Float const r = vmath::sqrt((Float(1) - z) * (Float(1) + z));
+    Float s, c;
+    vmath::sincos(Float(2) * std::numbers::pi_v<Float> * v, s, c);
+    x = r * c;
+    y = r * s;
+}
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_RANDOM_H
@@ -0,0 +1,226 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_REDUCED_H
+#define SPHERICAL_COLLECTION_REDUCED_H
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <algorithm>
+#include <string_view>
+
+#include "adaptive.h"
+#include "functions.h"
+#include "quadrature.h"
+
+namespace sphc
+{
+
+/**
+ * Integration reduced by the structure recorded in the function metadata
+ *
+ *  - half_space: the value on each side times the area of its spherical cap
+ *  - z_parity -1: zero, the hemispheres cancel
+ *  - zonal: 2 pi * integral of f(theta) sin(theta) over [0, pi]
+ *  - azimuthal: 2 * integral of f(phi) over [0, 2 pi]
+ *  - separable: both line integrals of f through (pi / 2, 0), minus the
+ *    4 pi f(pi / 2, 0) they count twice
+ *
+ * The line integrals are adaptive Gauss-Legendre quadratures in the angle
+ * itself, where the functions are smooth even if they are not on the sphere
+ * (o5 at the poles). Other functions fall back to adaptive::integrate, which
+ * does not report the kinked or pole-discontinuous ones (a1 - a6, o6) as
+ * converged.
+ */
+namespace reduced
+{
+
+enum class method : std::uint8_t
+{
+    cap_area,
+    odd_symmetry,
+    zonal,
+    azimuthal,
+    separable,
+    adaptive
+};
+
+template<typename Float>
+struct result
+{
+    Float estimate;             // surface integral estimate
+    Float error;                // estimated absolute error
+    std::size_t evaluations;
+    method used;
+    bool converged;             // the tolerance was met within max_evaluations
+};
+
+namespace
+{
+
+template<typename Float>
+struct line_integral
+{
+    Float value;
+    Float error;
+    std::size_t evaluations;
+    bool converged;
+};
+
+struct gauss_rule
+{
+    std::vector<double> nodes, weights;
+};
+
+/**
+ * Adaptive Gauss-Legendre quadrature on [a, b]
+ *
+ * Every interval compares its 10-point rule with the rules on its halves. The
+ * tolerance, the larger of the absolute one and the relative one of the
+ * 10-point rule over [a, b], is shared among the intervals in proportion to
+ * their length.
+ */
+template<typename Float, typename Fn>
+line_integral<Float> integrate_line(Fn const& f, double const a, double const b, double const absolute,
+    double const relative, std::size_t const max_evaluations)
+{
+    static gauss_rule const gauss = []()
+    {
+        gauss_rule r;
+        quadrature::gauss_legendre(10, r.nodes, r.weights);
+        return r;
+    }();
+    std::vector<double> const& nodes = gauss.nodes;
+    std::vector<double> const& weights = gauss.weights;
+
+    std::size_t evaluations = 0;
+    auto rule = [&](double const lo, double const hi)
+    {
+        double const center = 0.5 * (lo + hi), half = 0.5 * (hi - lo);
+        Float sum = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            sum += static_cast<Float>(weights[i]) * f(static_cast<Float>(center + half * nodes[i]));
+        evaluations += nodes.size();
+        return sum * static_cast<Float>(half);
+    };
+
+    struct interval
+    {
+        double lo, hi;
+        Float whole;
+    };
+
+    Float value = 0, error = 0;
+    bool converged = true;
+    std::vector<interval> pending{ { a, b, rule(a, b) } };
+    double const tolerance = std::max(absolute, relative * std::abs(static_cast<double>(pending[0].whole)));
+    while (!pending.empty())
+    {
+        interval const i = pending.back();
+        pending.pop_back();
+
+        double const mid = 0.5 * (i.lo + i.hi);
+        Float const left = rule(i.lo, mid), right = rule(mid, i.hi);
+        Float const difference = std::abs(left + right - i.whole);
+        bool const exhausted = evaluations >= max_evaluations || i.hi - i.lo < 1e-12 * (b - a);
+        if (difference <= tolerance * (i.hi - i.lo) / (b - a) || exhausted)
+        {
+            value += left + right;
+            error += difference;
+            converged = converged && !exhausted;
+            continue;
+        }
+        pending.push_back({ i.lo, mid, left });
+        pending.push_back({ mid, i.hi, right });
+    }
+    return { value, error, evaluations, converged };
+}
+
+} // namespace
+
+/**
+ * Integrate a function over the sphere, reduced by its structure where the
+ * metadata allows
+ *
+ * @param id The identifier of the function
+ * @param opt Tolerances and limits, also passed to adaptive::integrate
+ * @return The estimate, its error and the method used
+ */
+template<typename Float>
+result<Float> integrate(FunctionId const id, adaptive::options const& opt = {})
+{
+    function_metadata const meta = get_metadata(id);
+    Float constexpr pi = std::numbers::pi_v<Float>;
+
+    if (meta.form == structure::half_space)
+    {
+        discontinuity_plane const plane = *get_discontinuity_plane(id);
+        double const norm = std::sqrt(plane.nx * plane.nx + plane.ny * plane.ny + plane.nz * plane.nz);
+        function_xyz<Float> const f = get_function_xyz<Float>(id);
+        Float const nx = static_cast<Float>(plane.nx / norm);
+        Float const ny = static_cast<Float>(plane.ny / norm);
+        Float const nz = static_cast<Float>(plane.nz / norm);
+
+        // the cap n . p > offset has area 2 pi (1 - offset / |n|)
+        Float const above = 2 * pi * (1 - static_cast<Float>(plane.offset / norm));
+        Float const estimate = f(nx, ny, nz) * above + f(-nx, -ny, -nz) * (4 * pi - above);
+        return { estimate, 0, 2, method::cap_area, true };
+    }
+
+    if (meta.z_parity < 0)
+        return { 0, 0, 0, method::odd_symmetry, true };
+
+    function<Float> const f = get_function<Float>(id);
+    auto polar = [&](Float const theta) { return f(theta, 0) * std::sin(theta); };
+    auto azimuthal = [&](Float const phi) { return f(pi / 2, phi); };
+
+    switch (meta.form)
+    {
+        case structure::zonal:
+        {
+            line_integral<Float> const l = integrate_line<Float>(polar, 0.0, std::numbers::pi,
+                opt.absolute_tolerance / (2.0 * std::numbers::pi), opt.relative_tolerance, opt.max_evaluations);
+            return { 2 * pi * l.value, 2 * pi * l.error, l.evaluations, method::zonal, l.converged };
+        }
+        case structure::azimuthal:
+        {
+            line_integral<Float> const l = integrate_line<Float>(azimuthal, 0.0, 2.0 * std::numbers::pi,
+                opt.absolute_tolerance / 2.0, opt.relative_tolerance, opt.max_evaluations);
+            return { 2 * l.value, 2 * l.error, l.evaluations, method::azimuthal, l.converged };
+        }
+        case structure::separable:
+        {
+            line_integral<Float> const t = integrate_line<Float>(polar, 0.0, std::numbers::pi,
+                opt.absolute_tolerance / (4.0 * std::numbers::pi), opt.relative_tolerance / 2.0,
+                opt.max_evaluations / 2);
+            line_integral<Float> const p = integrate_line<Float>(azimuthal, 0.0, 2.0 * std::numbers::pi,
+                opt.absolute_tolerance / 4.0, opt.relative_tolerance / 2.0, opt.max_evaluations / 2);
+            Float const estimate = 2 * pi * t.value + 2 * p.value - 4 * pi * f(pi / 2, 0);
+            return { estimate, 2 * pi * t.error + 2 * p.error, t.evaluations + p.evaluations + 1, method::separable,
+                t.converged && p.converged };
+        }
+        default:
+        {
+            adaptive::result<Float> const r = adaptive::integrate<Float>(id, opt);
+            return { r.estimate, r.error, r.evaluations, method::adaptive, r.converged };
+        }
+    }
+}
+
+template<typename Float>
+result<Float> integrate(std::string_view const id, adaptive::options const& opt = {})
+{
+    return integrate<Float>(function_id(id), opt);
+}
+
+} // namespace reduced
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_REDUCED_H
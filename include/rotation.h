@@ -0,0 +1,222 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_ROTATION_H
+#define SPHERICAL_COLLECTION_ROTATION_H
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <algorithm>
+#include <string_view>
+
+#include "vmath.h"
+#include "random.h"
+#include "parallel.h"
+#include "functions.h"
+
+namespace sphc
+{
+
+/**
+ * Rotated copies of the functions, for benchmarks of rotation invariance
+ *
+ * The copy of f under the rotation R evaluates f(R p). Features aligned with
+ * the axes (the planes of d1, the poles of s2 and l2) lose their alignment with
+ * the grids, while the integral stays get_integral and the extremes stay
+ * get_maximum and get_minimum.
+ */
+namespace rotation
+{
+
+/**
+ * Rotation matrix, row major
+ */
+template<typename Float>
+struct matrix
+{
+    std::array<Float, 9> m;
+
+    /**
+     * Rotate the unit vector (x, y, z)
+     */
+    void apply(Float const x, Float const y, Float const z, Float& rx, Float& ry, Float& rz) const
+    {
+        rx = m[0] * x + m[1] * y + m[2] * z;
+        ry = m[3] * x + m[4] * y + m[5] * z;
+        rz = m[6] * x + m[7] * y + m[8] * z;
+    }
+
+    /**
+     * The inverse rotation
+     */
+    matrix transposed() const
+    {
+        return { { m[0], m[3], m[6], m[1], m[4], m[7], m[2], m[5], m[8] } };
+    }
+};
+
+template<typename Float>
+inline constexpr matrix<Float> identity = { { 1, 0, 0, 0, 1, 0, 0, 0, 1 } };
+
+/**
+ * Rotation matrix of the quaternion w + xi + yj + zk, which need not be
+ * normalized
+ */
+template<typename Float>
+matrix<Float> from_quaternion(Float const w, Float const x, Float const y, Float const z)
+{
+    Float const s = Float(2) / (w * w + x * x + y * y + z * z);
+    Float const xx = s * x * x, yy = s * y * y, zz = s * z * z;
+    Float const xy = s * x * y, xz = s * x * z, yz = s * y * z;
+    Float const wx = s * w * x, wy = s * w * y, wz = s * w * z;
+    return { {
+        1 - yy - zz, xy - wz, xz + wy,
+        xy + wz, 1 - xx - zz, yz - wx,
+        xz - wy, yz + wx, 1 - xx - yy
+    } };
+}
+
+// stream word of the Philox counter, after those of sampling
+inline constexpr std::uint32_t rotation_stream = 3;
+
+/**
+ * Uniformly distributed random rotation (Shoemake, "Uniform Random Rotations",
+ * Graphics Gems III)
+ *
+ * Rotation i is a pure function of (seed, i), drawn from the Philox counters
+ * (i_lo, i_hi, 0 and 1, rotation_stream).
+ *
+ * @param seed Stream seed
+ * @param index Index of the rotation in the stream
+ */
+template<typename Float>
+matrix<Float> uniform(std::uint64_t const seed, std::uint64_t const index)
+{
+    philox4x32::key_type const key = philox4x32::make_key(seed);
+    std::uint32_t const lo = static_cast<std::uint32_t>(index), hi = static_cast<std::uint32_t>(index >> 32);
+    auto const a = philox4x32::generate({ lo, hi, 0, rotation_stream }, key);
+    auto const b = philox4x32::generate({ lo, hi, 1, rotation_stream }, key);
+
+    Float const u = uniform_from_bits<Float>(a[0], a[1]);
+    Float const tau = 2 * std::numbers::pi_v<Float>;
+    Float s1, c1, s2, c2;
+    vmath::sincos(tau * uniform_from_bits<Float>(a[2], a[3]), s1, c1);
+    vmath::sincos(tau * uniform_from_bits<Float>(b[0], b[1]), s2, c2);
+    Float const r1 = vmath::sqrt(1 - u), r2 = vmath::sqrt(u);
+    return from_quaternion(r2 * c2, r1 * s1, r1 * c1, r2 * s2);
+}
+
+/**
+ * Rotations first, ..., first + count - 1 of a stream
+ */
+template<typename Float>
+std::vector<matrix<Float>> uniform_family(std::uint64_t const seed, std::size_t const count,
+    std::uint64_t const first = 0)
+{
+    std::vector<matrix<Float>> family(count);
+    for (std::size_t i = 0; i < count; ++i)
+        family[i] = uniform<Float>(seed, first + i);
+    return family;
+}
+
+/**
+ * A function composed with a rotation of its argument
+ */
+template<typename Float>
+struct rotated
+{
+    function_xyz<Float> fn;
+    matrix<Float> r;
+
+    rotated(FunctionId const id, matrix<Float> const& r) : fn(get_function_xyz<Float>(id)), r(r) {}
+    rotated(std::string_view const id, matrix<Float> const& r) : rotated(function_id(id), r) {}
+
+    Float operator()(Float const x, Float const y, Float const z) const
+    {
+        Float rx, ry, rz;
+        r.apply(x, y, z, rx, ry, rz);
+        return fn(rx, ry, rz);
+    }
+
+    Float operator()(Float const theta, Float const phi) const
+    {
+        auto const [x, y, z] = spherical_to_xyz<Float>(theta, phi);
+        return (*this)(x, y, z);
+    }
+};
+
+/**
+ * Evaluate a family of rotated copies of a function over a set of points
+ *
+ * The work is tiled like a matrix product: a tile of points stays in cache
+ * while a block of rotations is applied to it, and each rotated tile goes
+ * through the batch kernel of the function. Tiles run in parallel.
+ *
+ * @param id The identifier of the function
+ * @param rotations N rotations
+ * @param x, y, z M unit vectors
+ * @param out N x M values, out[i * M + j] = f(R_i p_j)
+ * @param threads Worker threads, 0 for hardware concurrency
+ */
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch_xyz(FunctionId const id, std::span<matrix<Float> const> rotations, std::span<Float const> x,
+    std::span<Float const> y, std::span<Float const> z, std::span<Float> out, unsigned const threads = 0)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && out.size() >= rotations.size() * x.size());
+
+    std::size_t constexpr tile_points = 1024;
+    std::size_t constexpr tile_rotations = 32;
+    std::size_t const points = x.size();
+    std::size_t const point_tiles = (points + tile_points - 1) / tile_points;
+    std::size_t const rotation_tiles = (rotations.size() + tile_rotations - 1) / tile_rotations;
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float, Math>(id);
+
+    parallel_for(point_tiles * rotation_tiles, threads, false, [&](std::size_t const tile, unsigned)
+    {
+        std::size_t const first = (tile % point_tiles) * tile_points;
+        std::size_t const count = std::min(tile_points, points - first);
+        std::size_t const r_first = (tile / point_tiles) * tile_rotations;
+        std::size_t const r_end = std::min(rotations.size(), r_first + tile_rotations);
+
+        std::vector<Float> rx(count), ry(count), rz(count);
+        Float const* __restrict px = x.data() + first;
+        Float const* __restrict py = y.data() + first;
+        Float const* __restrict pz = z.data() + first;
+        for (std::size_t i = r_first; i < r_end; ++i)
+        {
+            std::array<Float, 9> const m = rotations[i].m;
+            Float* __restrict ox = rx.data();
+            Float* __restrict oy = ry.data();
+            Float* __restrict oz = rz.data();
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                ox[j] = m[0] * px[j] + m[1] * py[j] + m[2] * pz[j];
+                oy[j] = m[3] * px[j] + m[4] * py[j] + m[5] * pz[j];
+                oz[j] = m[6] * px[j] + m[7] * py[j] + m[8] * pz[j];
+            }
+            fn(rx, ry, rz, out.subspan(i * points + first, count));
+        }
+    });
+}
+
+template<typename Float, typename Math = batch_math<Float>>
+void eval_batch_xyz(std::string_view const id, std::span<matrix<Float> const> rotations, std::span<Float const> x,
+    std::span<Float const> y, std::span<Float const> z, std::span<Float> out, unsigned const threads = 0)
+{
+    eval_batch_xyz<Float, Math>(function_id(id), rotations, x, y, z, out, threads);
+}
+
+} // namespace rotation
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_ROTATION_H
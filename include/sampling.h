@@ -0,0 +1,331 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_SAMPLING_H
+#define SPHERICAL_COLLECTION_SAMPLING_H
+
+#include <bit>
+#include <span>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <numbers>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include "functions.h"
+#include "grid.h"
+#include "montecarlo.h"
+#include "parallel.h"
+#include "random.h"
+#include "vmath.h"
+
+namespace sphc
+{
+
+/**
+ * Drawing directions distributed proportionally to a function
+ *
+ * Negative function values are treated as zero, so every function of the
+ * collection defines a distribution through its positive part.
+ */
+namespace sampling
+{
+
+struct sample_stats
+{
+    std::size_t accepted;       // samples written
+    std::size_t proposed;       // uniform directions drawn for them
+    double acceptance_rate;
+    double samples_per_second;
+};
+
+namespace
+{
+
+// stream words of the Philox counter, the proposals use word 0 like montecarlo
+inline constexpr std::uint32_t acceptance_stream = 1;
+inline constexpr std::uint32_t tabulated_stream = 2;
+
+// an accepted proposal of a block and its index in the block
+template<typename Float>
+struct candidate
+{
+    Float x, y, z;
+    std::size_t index;
+};
+
+template<typename Float>
+void rejection_block(batch_function_xyz<Float> const fn, Float const bound, std::uint64_t const seed,
+    std::uint64_t const block, std::vector<candidate<Float>>& accepted)
+{
+    std::size_t constexpr n = montecarlo::block_size;
+    std::vector<Float> x(n), y(n), z(n), values(n), u(n);
+    montecarlo::sample_block<Float>(seed, block, x, y, z);
+    fn(x, y, z, values);
+
+    philox4x32::key_type const key = philox4x32::make_key(seed);
+    std::uint32_t const block_lo = static_cast<std::uint32_t>(block);
+    std::uint32_t const block_hi = static_cast<std::uint32_t>(block >> 32);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto const bits = philox4x32::generate({ static_cast<std::uint32_t>(i), block_lo, block_hi, acceptance_stream }, key);
+        u[i] = uniform_from_bits<Float>(bits[0], bits[1]) * bound;
+    }
+
+    accepted.clear();
+    for (std::size_t i = 0; i < n; ++i)
+        if (u[i] < values[i])
+            accepted.push_back({ x[i], y[i], z[i], i });
+}
+
+} // namespace
+
+/**
+ * Draw directions by rejection against the global maximum of a function
+ *
+ * Uniform proposals are generated and evaluated in blocks of
+ * montecarlo::block_size through the batch kernels; a proposal p is accepted
+ * when u * get_maximum(id) < f(p). Blocks are processed in parallel and their
+ * accepted samples concatenated in block order, so the output is identical for
+ * a given (id, size, seed) regardless of the number of threads. Efficient
+ * while the acceptance rate, integral / (4 pi maximum), is not too small; see
+ * tabulated_distribution for peaked functions such as s2 and l2.
+ *
+ * @param id The identifier of the function
+ * @param x, y, z Output unit vector components, all of the same size
+ * @param seed Stream seed
+ * @param threads Worker threads, 0 for hardware concurrency
+ * @return Proposal counts and throughput
+ * @throws std::invalid_argument if the function has no positive values
+ */
+template<typename Float>
+sample_stats sample_rejection(FunctionId const id, std::span<Float> x, std::span<Float> y, std::span<Float> z,
+    std::uint64_t const seed = 0, unsigned const threads = 0)
+{
+    assert(y.size() == x.size() && z.size() == x.size());
+
+    auto const start = std::chrono::steady_clock::now();
+
+    // covers rounding of the evaluation above the tabulated maximum
+    Float const bound = get_maximum<Float>(id) * Float(1.00001);
+    if (!(bound > 0))
+        throw std::invalid_argument("function has no positive values to sample");
+
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(id);
+    unsigned const workers = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    std::size_t const round = 4 * static_cast<std::size_t>(workers);
+    std::vector<std::vector<candidate<Float>>> blocks(round);
+
+    std::size_t count = 0, proposed = 0;
+    for (std::uint64_t first = 0; count < x.size(); first += round)
+    {
+        parallel_for(round, threads, false, [&](std::size_t const b, unsigned)
+        {
+            rejection_block(fn, bound, seed, first + b, blocks[b]);
+        });
+
+        for (std::size_t b = 0; b < round && count < x.size(); ++b)
+        {
+            std::size_t const take = std::min(blocks[b].size(), x.size() - count);
+            for (std::size_t i = 0; i < take; ++i, ++count)
+            {
+                x[count] = blocks[b][i].x;
+                y[count] = blocks[b][i].y;
+                z[count] = blocks[b][i].z;
+            }
+            proposed += take < blocks[b].size() ? blocks[b][take - 1].index + 1 : montecarlo::block_size;
+        }
+    }
+
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {
+        count,
+        proposed,
+        proposed > 0 ? static_cast<double>(count) / static_cast<double>(proposed) : 0.0,
+        seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0
+    };
+}
+
+template<typename Float>
+sample_stats sample_rejection(std::string_view const id, std::span<Float> x, std::span<Float> y, std::span<Float> z,
+    std::uint64_t const seed = 0, unsigned const threads = 0)
+{
+    return sample_rejection<Float>(function_id(id), x, y, z, seed, threads);
+}
+
+/**
+ * Piecewise constant distribution over the cells of an equirectangular grid,
+ * with the function value at each cell center
+ *
+ * Samples are exactly distributed by the tabulated density, which approaches
+ * the function as the grid is refined, at a cost independent of the shape of
+ * the function.
+ */
+struct tabulated_distribution
+{
+    std::size_t rows;                   // theta cells over [0, pi]
+    std::size_t columns;                // phi cells over [0, 2 pi)
+    std::vector<double> marginal;       // CDF over rows, rows + 1 entries
+    std::vector<double> conditional;    // CDF over the columns of each row, columns + 1 entries per row
+    std::vector<double> density;        // per cell, with respect to solid angle
+    std::vector<double> z;              // cos(theta) at the row edges, rows + 1 entries
+};
+
+/**
+ * Tabulate a function for sampling
+ *
+ * @param id The identifier of the function
+ * @param rows Theta cells
+ * @param columns Phi cells
+ * @param threads Worker threads for the grid evaluation, 0 for hardware concurrency
+ * @return The distribution
+ * @throws std::invalid_argument if the tabulated function has no positive values
+ */
+template<typename Float>
+tabulated_distribution make_tabulated(FunctionId const id, std::size_t const rows = 512,
+    std::size_t const columns = 1024, unsigned const threads = 0)
+{
+    grid::equirectangular<Float> g(rows, columns);
+    grid::options opt;
+    opt.threads = threads;
+    grid::evaluate<Float>(id, g, opt);
+
+    tabulated_distribution d{ rows, columns, std::vector<double>(rows + 1, 0.0),
+        std::vector<double>(rows * (columns + 1), 0.0), std::vector<double>(rows * columns, 0.0),
+        std::vector<double>(rows + 1) };
+    for (std::size_t i = 0; i <= rows; ++i)
+        d.z[i] = std::cos(std::numbers::pi * static_cast<double>(i) / static_cast<double>(rows));
+
+    double const dphi = 2.0 * std::numbers::pi / static_cast<double>(columns);
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        double const area = dphi * (d.z[i] - d.z[i + 1]);
+        double* cdf = &d.conditional[i * (columns + 1)];
+        for (std::size_t j = 0; j < columns; ++j)
+            cdf[j + 1] = cdf[j] + std::max(0.0, static_cast<double>(g(i, j))) * area;
+        d.marginal[i + 1] = d.marginal[i] + cdf[columns];
+    }
+
+    double const total = d.marginal[rows];
+    if (!(total > 0.0))
+        throw std::invalid_argument("function has no positive values to sample");
+
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        double* cdf = &d.conditional[i * (columns + 1)];
+        for (std::size_t j = 0; j < columns; ++j)
+            d.density[i * columns + j] = std::max(0.0, static_cast<double>(g(i, j))) / total;
+        double const row_total = cdf[columns];
+        for (std::size_t j = 1; j <= columns; ++j)
+            cdf[j] = row_total > 0.0 ? cdf[j] / row_total : static_cast<double>(j) / static_cast<double>(columns);
+        d.marginal[i + 1] /= total;
+    }
+    d.marginal[rows] = 1.0;
+    return d;
+}
+
+template<typename Float>
+tabulated_distribution make_tabulated(std::string_view const id, std::size_t const rows = 512,
+    std::size_t const columns = 1024, unsigned const threads = 0)
+{
+    return make_tabulated<Float>(function_id(id), rows, columns, threads);
+}
+
+namespace
+{
+
+// the interval [cdf[k], cdf[k + 1]) containing u, the last k with cdf[k] <= u,
+// so empty intervals are skipped; a branchless binary search
+inline std::size_t find_interval(double const* cdf, std::size_t const count, double const u)
+{
+    std::size_t k = 0;
+    for (std::size_t step = std::bit_floor(count); step > 0; step >>= 1)
+        k = (k + step < count && cdf[k + step] <= u) ? k + step : k;
+    return k;
+}
+
+} // namespace
+
+/**
+ * Draw directions from a tabulated distribution
+ *
+ * Sample i is a pure function of (seed, first + i), so any range of the stream
+ * can be generated independently, e.g. by several threads.
+ *
+ * @param d Distribution
+ * @param x, y, z Output unit vector components, all of the same size
+ * @param seed Stream seed
+ * @param first Index of the first sample in the stream
+ * @return Sample count and throughput; every proposal is accepted
+ */
+template<typename Float>
+sample_stats sample_tabulated(tabulated_distribution const& d, std::span<Float> x, std::span<Float> y,
+    std::span<Float> z, std::uint64_t const seed = 0, std::uint64_t const first = 0)
+{
+    assert(y.size() == x.size() && z.size() == x.size());
+
+    auto const start = std::chrono::steady_clock::now();
+
+    philox4x32::key_type const key = philox4x32::make_key(seed);
+    double const dphi = 2.0 * std::numbers::pi / static_cast<double>(d.columns);
+
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        std::uint64_t const index = first + i;
+        auto const bits = philox4x32::generate({ static_cast<std::uint32_t>(index),
+            static_cast<std::uint32_t>(index >> 32), 0, tabulated_stream }, key);
+
+        std::size_t const row = find_interval(d.marginal.data(), d.rows, uniform_from_bits<double>(bits[0]));
+        std::size_t const column = find_interval(&d.conditional[row * (d.columns + 1)], d.columns,
+            uniform_from_bits<double>(bits[1]));
+
+        // uniform by area within the cell
+        double const cz = d.z[row] + (d.z[row + 1] - d.z[row]) * uniform_from_bits<double>(bits[2]);
+        double const phi = dphi * (static_cast<double>(column) + uniform_from_bits<double>(bits[3]));
+        double const r = std::sqrt(std::max(0.0, (1.0 - cz) * (1.0 + cz)));
+        double sin_phi, cos_phi;
+        vmath::sincos(phi, sin_phi, cos_phi);
+        x[i] = static_cast<Float>(r * cos_phi);
+        y[i] = static_cast<Float>(r * sin_phi);
+        z[i] = static_cast<Float>(cz);
+    }
+
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return { x.size(), x.size(), 1.0, seconds > 0.0 ? static_cast<double>(x.size()) / seconds : 0.0 };
+}
+
+/**
+ * Density of a tabulated distribution with respect to solid angle
+ *
+ * @param d Distribution
+ * @param x, y, z Unit vector
+ * @return The density of the cell containing the direction
+ */
+inline double pdf(tabulated_distribution const& d, double const x, double const y, double const z)
+{
+    double const theta = std::atan2(std::sqrt(x * x + y * y), z);
+    double phi = std::atan2(y, x);
+    if (phi < 0.0)
+        phi += 2.0 * std::numbers::pi;
+
+    std::size_t const row = std::min(d.rows - 1,
+        static_cast<std::size_t>(theta / std::numbers::pi * static_cast<double>(d.rows)));
+    std::size_t const column = std::min(d.columns - 1,
+        static_cast<std::size_t>(phi / (2.0 * std::numbers::pi) * static_cast<double>(d.columns)));
+    return d.density[row * d.columns + column];
+}
+
+} // namespace sampling
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_SAMPLING_H
@@ -0,0 +1,311 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_SHT_H
+#define SPHERICAL_COLLECTION_SHT_H
+
+#include <map>
+#include <span>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <complex>
+#include <numbers>
+#include <cassert>
+#include <cstddef>
+#include <string_view>
+
+#include "functions.h"
+#include "parallel.h"
+#include "quadrature.h"
+
+namespace sphc
+{
+
+/**
+ * Spherical harmonic transform
+ *
+ * Functions are projected onto orthonormal complex spherical harmonics
+ *
+ *   Y_lm(theta, phi) = N_lm P_lm(cos theta) e^{i m phi}
+ *
+ * with the Condon-Shortley phase, for all degrees l < L (the bandlimit). The
+ * function is sampled on L Gauss-Legendre nodes in cos(theta) times a power of
+ * two >= 2L equispaced azimuths, so the transform is exact for band-limited
+ * functions. Each ring is transformed by an FFT in phi and the normalized
+ * associated Legendre functions are generated by the three-term recurrence in
+ * l for each order m, which costs O(L^3) in total.
+ */
+namespace sht
+{
+
+/**
+ * Quadrature nodes, FFT twiddles and Legendre recurrence coefficients for one
+ * bandlimit
+ */
+struct tables
+{
+    std::size_t bandlimit;
+    std::size_t rings;                      // Gauss-Legendre nodes in cos(theta)
+    std::size_t azimuths;                   // samples per ring, a power of two
+    std::vector<double> cos_theta;
+    std::vector<double> sin_theta;
+    std::vector<double> weights;
+    std::vector<std::complex<double>> twiddles;     // e^{-2 pi i k / azimuths}, k < azimuths / 2
+    std::vector<double> alpha;              // P_lm = alpha_lm (x P_l-1,m - beta_lm P_l-2,m)
+    std::vector<double> beta;
+    std::vector<double> diagonal;           // P_mm = -diagonal_m sin(theta) P_m-1,m-1
+};
+
+/**
+ * Coefficients a_lm for 0 <= m <= l < bandlimit, a_l,-m = (-1)^m conj(a_lm)
+ * for the real functions of the collection
+ */
+struct spectrum
+{
+    std::size_t bandlimit;
+    std::vector<std::complex<double>> coefficients;     // index l (l + 1) / 2 + m
+    std::vector<double> energy;                         // sum over m of |a_lm|^2, per degree l
+
+    static constexpr std::size_t index(std::size_t const l, std::size_t const m) { return l * (l + 1) / 2 + m; }
+
+    std::complex<double> coefficient(std::size_t const l, long const m) const
+    {
+        std::complex<double> const c = coefficients[index(l, static_cast<std::size_t>(m < 0 ? -m : m))];
+        return m >= 0 ? c : ((m & 1) ? -std::conj(c) : std::conj(c));
+    }
+};
+
+namespace
+{
+
+inline tables make_tables(std::size_t const bandlimit)
+{
+    tables t;
+    t.bandlimit = bandlimit;
+    t.rings = bandlimit;
+    t.azimuths = 1;
+    while (t.azimuths < 2 * bandlimit)
+        t.azimuths *= 2;
+
+    std::vector<double> nodes;
+    quadrature::gauss_legendre(t.rings, nodes, t.weights);
+    t.cos_theta = nodes;
+    t.sin_theta.resize(t.rings);
+    for (std::size_t i = 0; i < t.rings; ++i)
+        t.sin_theta[i] = std::sqrt((1.0 - nodes[i]) * (1.0 + nodes[i]));
+
+    t.twiddles.resize(t.azimuths / 2);
+    for (std::size_t k = 0; k < t.azimuths / 2; ++k)
+        t.twiddles[k] = std::polar(1.0, -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(t.azimuths));
+
+    std::size_t const count = bandlimit * (bandlimit + 1) / 2;
+    t.alpha.assign(count, 0.0);
+    t.beta.assign(count, 0.0);
+    for (std::size_t m = 0; m < bandlimit; ++m)
+        for (std::size_t l = m + 1; l < bandlimit; ++l)
+        {
+            double const ll = static_cast<double>(l);
+            double const mm = static_cast<double>(m);
+            t.alpha[spectrum::index(l, m)] = std::sqrt((4.0 * ll * ll - 1.0) / (ll * ll - mm * mm));
+            t.beta[spectrum::index(l, m)] = std::sqrt(((ll - 1.0) * (ll - 1.0) - mm * mm) / (4.0 * (ll - 1.0) * (ll - 1.0) - 1.0));
+        }
+
+    t.diagonal.assign(bandlimit, 0.0);
+    for (std::size_t m = 1; m < bandlimit; ++m)
+        t.diagonal[m] = std::sqrt((2.0 * static_cast<double>(m) + 1.0) / (2.0 * static_cast<double>(m)));
+
+    return t;
+}
+
+// in-place iterative radix-2 FFT, forward sign
+inline void fft(std::span<std::complex<double>> a, std::vector<std::complex<double>> const& twiddles)
+{
+    std::size_t const n = a.size();
+    for (std::size_t i = 1, j = 0; i < n; ++i)
+    {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+
+    for (std::size_t len = 2; len <= n; len <<= 1)
+    {
+        std::size_t const stride = n / len;
+        for (std::size_t start = 0; start < n; start += len)
+            for (std::size_t k = 0; k < len / 2; ++k)
+            {
+                std::complex<double> const u = a[start + k];
+                std::complex<double> const v = a[start + k + len / 2] * twiddles[k * stride];
+                a[start + k] = u + v;
+                a[start + k + len / 2] = u - v;
+            }
+    }
+}
+
+} // namespace
+
+/**
+ * Get the tables for a bandlimit, computed once and cached
+ *
+ * @param bandlimit Number of degrees L, at least 1
+ * @return Shared immutable tables
+ */
+inline std::shared_ptr<tables const> get_tables(std::size_t const bandlimit)
+{
+    assert(bandlimit >= 1);
+
+    static std::mutex mutex;
+    static std::map<std::size_t, std::shared_ptr<tables const>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[bandlimit];
+    if (!entry)
+        entry = std::make_shared<tables const>(make_tables(bandlimit));
+    return entry;
+}
+
+/**
+ * Project a function onto spherical harmonics of degree below the bandlimit
+ *
+ * Rings are sampled and transformed in parallel, then the orders m are
+ * distributed over the threads.
+ *
+ * @param id The identifier of the function
+ * @param bandlimit Number of degrees L
+ * @param threads Worker threads, 0 for hardware concurrency
+ * @return Coefficients and energy per degree
+ */
+template<typename Float>
+spectrum analyze(FunctionId const id, std::size_t const bandlimit, unsigned const threads = 0)
+{
+    std::shared_ptr<tables const> const tp = get_tables(bandlimit);
+    tables const& t = *tp;
+    batch_function<Float> const fn = get_batch_function<Float>(id);
+
+    std::size_t const L = bandlimit;
+    std::size_t const n = t.azimuths;
+
+    // F_m(theta_i) = integral of f(theta_i, phi) e^{-i m phi} dphi, for m < L
+    std::vector<std::complex<double>> rings(t.rings * L);
+    parallel_for(t.rings, threads, false, [&](std::size_t const i, unsigned)
+    {
+        std::vector<Float> theta(n, static_cast<Float>(std::atan2(t.sin_theta[i], t.cos_theta[i])));
+        std::vector<Float> phi(n), values(n);
+        for (std::size_t j = 0; j < n; ++j)
+            phi[j] = static_cast<Float>(2.0 * std::numbers::pi * static_cast<double>(j) / static_cast<double>(n));
+        fn(theta, phi, values);
+
+        std::vector<std::complex<double>> ring(values.begin(), values.end());
+        fft(ring, t.twiddles);
+        double const scale = 2.0 * std::numbers::pi / static_cast<double>(n);
+        for (std::size_t m = 0; m < L; ++m)
+            rings[i * L + m] = ring[m] * scale;
+    });
+
+    spectrum s{ L, std::vector<std::complex<double>>(L * (L + 1) / 2), std::vector<double>(L, 0.0) };
+    parallel_for(L, threads, false, [&](std::size_t const m, unsigned)
+    {
+        for (std::size_t i = 0; i < t.rings; ++i)
+        {
+            double const x = t.cos_theta[i];
+            std::complex<double> const fw = rings[i * L + m] * t.weights[i];
+
+            // normalized P_mm, P_m+1,m, then the recurrence in l
+            double pmm = 0.5 / std::sqrt(std::numbers::pi);
+            for (std::size_t k = 1; k <= m; ++k)
+                pmm *= -t.diagonal[k] * t.sin_theta[i];
+
+            double p2 = 0.0;
+            double p1 = pmm;
+            s.coefficients[spectrum::index(m, m)] += fw * p1;
+            for (std::size_t l = m + 1; l < L; ++l)
+            {
+                double const p = t.alpha[spectrum::index(l, m)] * (x * p1 - t.beta[spectrum::index(l, m)] * p2);
+                s.coefficients[spectrum::index(l, m)] += fw * p;
+                p2 = p1;
+                p1 = p;
+            }
+        }
+    });
+
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        s.energy[l] = std::norm(s.coefficients[spectrum::index(l, 0)]);
+        for (std::size_t m = 1; m <= l; ++m)
+            s.energy[l] += 2.0 * std::norm(s.coefficients[spectrum::index(l, m)]);
+    }
+    return s;
+}
+
+template<typename Float>
+spectrum analyze(std::string_view const id, std::size_t const bandlimit, unsigned const threads = 0)
+{
+    return analyze<Float>(function_id(id), bandlimit, threads);
+}
+
+/**
+ * Project every function of the collection, indexed by FunctionId
+ */
+template<typename Float>
+std::vector<spectrum> analyze_all(std::size_t const bandlimit, unsigned const threads = 0)
+{
+    std::vector<spectrum> spectra;
+    spectra.reserve(function_count);
+    for (std::size_t i = 0; i < function_count; ++i)
+        spectra.push_back(analyze<Float>(static_cast<FunctionId>(i), bandlimit, threads));
+    return spectra;
+}
+
+/**
+ * Evaluate a spectrum at a direction
+ *
+ * @param s Spectrum
+ * @param theta Polar angle
+ * @param phi Azimuthal angle
+ * @return The band-limited approximation of the function
+ */
+inline double synthesize(spectrum const& s, double const theta, double const phi)
+{
+    std::shared_ptr<tables const> const tp = get_tables(s.bandlimit);
+    tables const& t = *tp;
+    double const x = std::cos(theta);
+    double const sin_theta = std::sin(theta);
+
+    double sum = 0.0;
+    double pmm = 0.5 / std::sqrt(std::numbers::pi);
+    for (std::size_t m = 0; m < s.bandlimit; ++m)
+    {
+        if (m > 0)
+            pmm *= -t.diagonal[m] * sin_theta;
+
+        // sum over l of a_lm P_lm, then the +m and -m terms together
+        std::complex<double> partial = s.coefficients[spectrum::index(m, m)] * pmm;
+        double p2 = 0.0;
+        double p1 = pmm;
+        for (std::size_t l = m + 1; l < s.bandlimit; ++l)
+        {
+            double const p = t.alpha[spectrum::index(l, m)] * (x * p1 - t.beta[spectrum::index(l, m)] * p2);
+            partial += s.coefficients[spectrum::index(l, m)] * p;
+            p2 = p1;
+            p1 = p;
+        }
+
+        std::complex<double> const e = std::polar(1.0, static_cast<double>(m) * phi);
+        sum += (m == 0 ? 1.0 : 2.0) * (partial * e).real();
+    }
+    return sum;
+}
+
+} // namespace sht
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_SHT_H
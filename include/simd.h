@@ -0,0 +1,316 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_SIMD_H
+#define SPHERICAL_COLLECTION_SIMD_H
+
+#include <span>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPHC_SIMD_X86 1
+#else
+#define SPHC_SIMD_X86 0
+#endif
+
+#if defined(__clang__)
+#define SPHC_VECTORIZE _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__) && defined(SPHC_OPENMP_SIMD)
+#define SPHC_VECTORIZE _Pragma("omp simd")
+#elif defined(__GNUC__)
+#define SPHC_VECTORIZE _Pragma("GCC ivdep")
+#else
+#define SPHC_VECTORIZE
+#endif
+
+namespace sphc
+{
+
+/**
+ * Instruction set levels with a dedicated kernel
+ */
+enum class simd_level : std::uint8_t
+{
+    generic,
+    sse42,
+    avx2,
+    avx512
+};
+
+/**
+ * Detect the highest instruction set level supported by the running CPU
+ */
+inline simd_level detect_simd_level()
+{
+#if SPHC_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return simd_level::sse42;
+#endif
+    return simd_level::generic;
+}
+
+// the level shared by every translation unit, an inline function with external
+// linkage has a single static local in the whole program
+inline simd_level& simd_level_override()
+{
+    static simd_level level = detect_simd_level();
+    return level;
+}
+
+/**
+ * Instruction set level used by the dispatched batch kernels
+ */
+inline simd_level active_simd_level()
+{
+    return simd_level_override();
+}
+
+/**
+ * Restrict the dispatched batch kernels to a lower instruction set level
+ *
+ * Levels above the detected one are clamped, so this cannot select a kernel
+ * the CPU cannot run. Not thread-safe with respect to concurrent evaluation.
+ */
+inline void set_simd_level(simd_level const level)
+{
+    simd_level const detected = detect_simd_level();
+    simd_level_override() = level < detected ? level : detected;
+}
+
+/**
+ * Per-ISA batch kernels
+ *
+ * Each kernel flattens the scalar function into a vectorized loop compiled for
+ * its target; with the vector_math policy no libm calls remain in the loop body.
+ */
+namespace kernels
+{
+
+#define SPHC_DEFINE_KERNELS(suffix, attr)                                                                   \
+    template<typename Float, Float (*Fn)(Float, Float)>                                                    \
+    attr void batch_##suffix(Float const* __restrict t, Float const* __restrict p,                        \
+        Float* __restrict o, std::size_t const n)                                                          \
+    {                                                                                                       \
+        SPHC_VECTORIZE                                                                                      \
+        for (std::size_t i = 0; i < n; ++i)                                                                 \
+            o[i] = Fn(t[i], p[i]);                                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    template<typename Float, Float (*Fn)(Float, Float, Float)>                                             \
+    attr void batch_xyz_##suffix(Float const* __restrict x, Float const* __restrict y,                    \
+        Float const* __restrict z, Float* __restrict o, std::size_t const n)                               \
+    {                                                                                                       \
+        SPHC_VECTORIZE                                                                                      \
+        for (std::size_t i = 0; i < n; ++i)                                                                 \
+            o[i] = Fn(x[i], y[i], z[i]);                                                                    \
+    }                                                                                                       \
+                                                                                                            \
+    template<typename Float, void (*Fn)(Float, Float, Float&, Float&, Float&)>                             \
+    attr void batch3_##suffix(Float const* __restrict t, Float const* __restrict p,                       \
+        Float* __restrict a, Float* __restrict b, Float* __restrict c, std::size_t const n)                \
+    {                                                                                                       \
+        SPHC_VECTORIZE                                                                                      \
+        for (std::size_t i = 0; i < n; ++i)                                                                 \
+            Fn(t[i], p[i], a[i], b[i], c[i]);                                                               \
+    }                                                                                                       \
+                                                                                                            \
+    template<typename Float, void (*Fn)(Float, Float, Float, Float&, Float&, Float&)>                      \
+    attr void batch_xyz3_##suffix(Float const* __restrict x, Float const* __restrict y,                   \
+        Float const* __restrict z, Float* __restrict a, Float* __restrict b, Float* __restrict c,          \
+        std::size_t const n)                                                                               \
+    {                                                                                                       \
+        SPHC_VECTORIZE                                                                                      \
+        for (std::size_t i = 0; i < n; ++i)                                                                 \
+            Fn(x[i], y[i], z[i], a[i], b[i], c[i]);                                                         \
+    }                                                                                                       \
+                                                                                                            \
+    template<typename Float, void (*Fn)(Float, Float, Float, Float&, Float&, Float&, Float&)>              \
+    attr void batch_xyz4_##suffix(Float const* __restrict x, Float const* __restrict y,                   \
+        Float const* __restrict z, Float* __restrict a, Float* __restrict b, Float* __restrict c,          \
+        Float* __restrict d, std::size_t const n)                                                          \
+    {                                                                                                       \
+        SPHC_VECTORIZE                                                                                      \
+        for (std::size_t i = 0; i < n; ++i)                                                                 \
+            Fn(x[i], y[i], z[i], a[i], b[i], c[i], d[i]);                                                   \
+    }
+
+SPHC_DEFINE_KERNELS(generic, __attribute__((flatten)))
+#if SPHC_SIMD_X86
+SPHC_DEFINE_KERNELS(sse42, __attribute__((flatten, target("sse4.2"))))
+SPHC_DEFINE_KERNELS(avx2, __attribute__((flatten, target("avx2,fma"))))
+SPHC_DEFINE_KERNELS(avx512, __attribute__((flatten, target("avx512f,avx512dq,avx512vl,avx2,fma,prefer-vector-width=512"))))
+#endif
+
+#undef SPHC_DEFINE_KERNELS
+
+} // namespace kernels
+
+/**
+ * Evaluate a function over contiguous arrays of angles using the widest
+ * kernel supported by the running CPU
+ *
+ * @param theta Polar angles
+ * @param phi Azimuthal angles, same size as theta
+ * @param out Output values, at least as large as theta
+ */
+template<typename Float, Float (*Fn)(Float, Float)>
+void eval_batch_simd(std::span<Float const> theta, std::span<Float const> phi, std::span<Float> out)
+{
+    assert(phi.size() == theta.size() && out.size() >= theta.size());
+
+    Float const* t = theta.data();
+    Float const* p = phi.data();
+    Float* o = out.data();
+    std::size_t const n = theta.size();
+
+    switch (active_simd_level())
+    {
+#if SPHC_SIMD_X86
+        case simd_level::avx512: kernels::batch_avx512<Float, Fn>(t, p, o, n); break;
+        case simd_level::avx2:   kernels::batch_avx2<Float, Fn>(t, p, o, n); break;
+        case simd_level::sse42:  kernels::batch_sse42<Float, Fn>(t, p, o, n); break;
+#endif
+        default:                 kernels::batch_generic<Float, Fn>(t, p, o, n); break;
+    }
+}
+
+/**
+ * Evaluate a function over contiguous arrays of unit vector components using
+ * the widest kernel supported by the running CPU
+ *
+ * @param x, y, z Unit vector components, all of the same size
+ * @param out Output values, at least as large as x
+ */
+template<typename Float, Float (*Fn)(Float, Float, Float)>
+void eval_batch_xyz_simd(std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+    std::span<Float> out)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && out.size() >= x.size());
+
+    Float const* px = x.data();
+    Float const* py = y.data();
+    Float const* pz = z.data();
+    Float* o = out.data();
+    std::size_t const n = x.size();
+
+    switch (active_simd_level())
+    {
+#if SPHC_SIMD_X86
+        case simd_level::avx512: kernels::batch_xyz_avx512<Float, Fn>(px, py, pz, o, n); break;
+        case simd_level::avx2:   kernels::batch_xyz_avx2<Float, Fn>(px, py, pz, o, n); break;
+        case simd_level::sse42:  kernels::batch_xyz_sse42<Float, Fn>(px, py, pz, o, n); break;
+#endif
+        default:                 kernels::batch_xyz_generic<Float, Fn>(px, py, pz, o, n); break;
+    }
+}
+
+/**
+ * Evaluate a function with three outputs over contiguous arrays of angles,
+ * such as the conversion to unit vectors, using the widest kernel supported by
+ * the running CPU
+ *
+ * @param theta Polar angles
+ * @param phi Azimuthal angles, same size as theta
+ * @param a, b, c Output values, each at least as large as theta
+ */
+template<typename Float, void (*Fn)(Float, Float, Float&, Float&, Float&)>
+void eval_batch3_simd(std::span<Float const> theta, std::span<Float const> phi, std::span<Float> a,
+    std::span<Float> b, std::span<Float> c)
+{
+    assert(phi.size() == theta.size() && a.size() >= theta.size() && b.size() >= theta.size() &&
+        c.size() >= theta.size());
+
+    Float const* t = theta.data();
+    Float const* p = phi.data();
+    std::size_t const n = theta.size();
+
+    switch (active_simd_level())
+    {
+#if SPHC_SIMD_X86
+        case simd_level::avx512: kernels::batch3_avx512<Float, Fn>(t, p, a.data(), b.data(), c.data(), n); break;
+        case simd_level::avx2:   kernels::batch3_avx2<Float, Fn>(t, p, a.data(), b.data(), c.data(), n); break;
+        case simd_level::sse42:  kernels::batch3_sse42<Float, Fn>(t, p, a.data(), b.data(), c.data(), n); break;
+#endif
+        default:                 kernels::batch3_generic<Float, Fn>(t, p, a.data(), b.data(), c.data(), n); break;
+    }
+}
+
+/**
+ * Evaluate a function with three outputs over contiguous arrays of unit vector
+ * components, such as the mapping to texture coordinates, using the widest
+ * kernel supported by the running CPU
+ *
+ * @param x, y, z Unit vector components, all of the same size
+ * @param a, b, c Output values, each at least as large as x
+ */
+template<typename Float, void (*Fn)(Float, Float, Float, Float&, Float&, Float&)>
+void eval_batch_xyz3_simd(std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+    std::span<Float> a, std::span<Float> b, std::span<Float> c)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && a.size() >= x.size() && b.size() >= x.size() &&
+        c.size() >= x.size());
+
+    Float const* px = x.data();
+    Float const* py = y.data();
+    Float const* pz = z.data();
+    std::size_t const n = x.size();
+
+    switch (active_simd_level())
+    {
+#if SPHC_SIMD_X86
+        case simd_level::avx512: kernels::batch_xyz3_avx512<Float, Fn>(px, py, pz, a.data(), b.data(), c.data(), n); break;
+        case simd_level::avx2:   kernels::batch_xyz3_avx2<Float, Fn>(px, py, pz, a.data(), b.data(), c.data(), n); break;
+        case simd_level::sse42:  kernels::batch_xyz3_sse42<Float, Fn>(px, py, pz, a.data(), b.data(), c.data(), n); break;
+#endif
+        default:                 kernels::batch_xyz3_generic<Float, Fn>(px, py, pz, a.data(), b.data(), c.data(), n); break;
+    }
+}
+
+/**
+ * Evaluate a function with four outputs over contiguous arrays of unit vector
+ * components, such as a value and its gradient, using the widest kernel
+ * supported by the running CPU
+ *
+ * @param x, y, z Unit vector components, all of the same size
+ * @param a, b, c, d Output values, each at least as large as x
+ */
+template<typename Float, void (*Fn)(Float, Float, Float, Float&, Float&, Float&, Float&)>
+void eval_batch_xyz4_simd(std::span<Float const> x, std::span<Float const> y, std::span<Float const> z,
+    std::span<Float> a, std::span<Float> b, std::span<Float> c, std::span<Float> d)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && a.size() >= x.size() && b.size() >= x.size() &&
+        c.size() >= x.size() && d.size() >= x.size());
+
+    Float const* px = x.data();
+    Float const* py = y.data();
+    Float const* pz = z.data();
+    Float* pa = a.data();
+    Float* pb = b.data();
+    Float* pc = c.data();
+    Float* pd = d.data();
+    std::size_t const n = x.size();
+
+    switch (active_simd_level())
+    {
+#if SPHC_SIMD_X86
+        case simd_level::avx512: kernels::batch_xyz4_avx512<Float, Fn>(px, py, pz, pa, pb, pc, pd, n); break;
+        case simd_level::avx2:   kernels::batch_xyz4_avx2<Float, Fn>(px, py, pz, pa, pb, pc, pd, n); break;
+        case simd_level::sse42:  kernels::batch_xyz4_sse42<Float, Fn>(px, py, pz, pa, pb, pc, pd, n); break;
+#endif
+        default:                 kernels::batch_xyz4_generic<Float, Fn>(px, py, pz, pa, pb, pc, pd, n); break;
+    }
+}
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_SIMD_H
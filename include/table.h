@@ -0,0 +1,600 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_TABLE_H
+#define SPHERICAL_COLLECTION_TABLE_H
+
+#include <map>
+#include <span>
+#include <array>
+#include <cmath>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <istream>
+#include <numbers>
+#include <ostream>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include "functions.h"
+#include "parallel.h"
+#include "vmath.h"
+
+namespace sphc
+{
+
+/**
+ * Precomputed tables of functions with interpolated lookup
+ *
+ * A function is sampled once at the texel centers of a grid and looked up at
+ * arbitrary directions by bilinear or bicubic (Catmull-Rom) interpolation.
+ * Every face carries an apron of two texels sampled beyond its edges, across
+ * the poles, seams and folds of the parameterization, so interpolation never
+ * has to wrap. Texels are stored in 8 x 8 tiles, which keeps the 4 x 4
+ * neighbourhood of a lookup within one or two cache lines per row.
+ */
+namespace table
+{
+
+/**
+ * Grid layouts
+ *
+ * The equirectangular grid is smooth everywhere but the poles and needs two
+ * arc tangents per lookup. The octahedral map is the cheapest to address and
+ * the most compact, but it is only continuous across the coordinate planes,
+ * where bicubic interpolation degrades to first order. Cube maps are the most
+ * uniform and accurate per texel at six times the texels of the octahedral map.
+ */
+enum class layout : std::uint8_t
+{
+    equirectangular,    // resolution rows in theta, 2 x resolution columns in phi
+    octahedral,         // resolution^2 texels over the octahedral map of the sphere to a square
+    cubemap             // six faces of resolution^2 texels
+};
+
+enum class interpolation : std::uint8_t
+{
+    bilinear,
+    bicubic
+};
+
+/**
+ * Tabulated function, immutable after construction and therefore safe to
+ * share between threads
+ */
+template<typename Float>
+struct tabulated
+{
+    static constexpr std::size_t apron = 2;
+    static constexpr std::size_t tile = 8;
+
+    FunctionId id;
+    layout kind;
+    std::size_t width;                  // texels per face row
+    std::size_t height;                 // texel rows per face
+    std::size_t faces;
+    std::size_t tiles_across;           // tiles per padded face row
+    std::size_t face_size;              // stored texels per face, in whole tiles
+    double max_error_bilinear;          // largest error at nine points of every texel cell
+    double max_error_bicubic;
+    std::vector<Float> texels;
+
+    /**
+     * Stored index of a texel, row and column may reach apron texels beyond the
+     * face
+     */
+    std::size_t index(std::size_t const face, std::ptrdiff_t const row, std::ptrdiff_t const column) const
+    {
+        return face * face_size + row_offset(row) + column_offset(column);
+    }
+
+    /**
+     * Parts of index within a face; the offsets of a neighbourhood's rows and
+     * columns are computed once and summed
+     */
+    std::size_t row_offset(std::ptrdiff_t const row) const
+    {
+        std::size_t const r = static_cast<std::size_t>(row + static_cast<std::ptrdiff_t>(apron));
+        return (r / tile) * tiles_across * tile * tile + (r % tile) * tile;
+    }
+
+    std::size_t column_offset(std::ptrdiff_t const column) const
+    {
+        std::size_t const c = static_cast<std::size_t>(column + static_cast<std::ptrdiff_t>(apron));
+        return (c / tile) * tile * tile + c % tile;
+    }
+};
+
+namespace
+{
+
+// face frames in the order +x, -x, +y, -y, +z, -z; face_coordinates relies on them
+struct cube_face
+{
+    std::array<double, 3> axis, right, up;
+};
+
+inline constexpr std::array<cube_face, 6> cube_faces =
+{{
+    { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+    { { -1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+    { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },
+    { { 0, -1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },
+    { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+    { { 0, 0, -1 }, { 1, 0, 0 }, { 0, 1, 0 } }
+}};
+
+inline std::array<double, 3> normalize(double const x, double const y, double const z)
+{
+    double const len = std::sqrt(x * x + y * y + z * z);
+    return { x / len, y / len, z / len };
+}
+
+// reflect a point beyond an edge of the octahedral square onto the texel it
+// continues into; the edge u = 1 is glued to itself with v mirrored
+inline void fold_octahedral(double& u, double& v)
+{
+    if (u > 1.0 || u < -1.0)
+    {
+        u = (u > 0.0 ? 2.0 : -2.0) - u;
+        v = -v;
+    }
+    if (v > 1.0 || v < -1.0)
+    {
+        v = (v > 0.0 ? 2.0 : -2.0) - v;
+        u = -u;
+    }
+}
+
+/**
+ * Direction of the continuous texel coordinates (s, t) of a face, texel
+ * centers at integers; apron coordinates continue across the face edges
+ */
+inline std::array<double, 3> texel_direction(layout const kind, std::size_t const width, std::size_t const height,
+    std::size_t const face, double const s, double const t)
+{
+    switch (kind)
+    {
+        case layout::equirectangular:
+        {
+            // theta beyond [0, pi] passes over the pole through the sign of sin(theta)
+            double const theta = (t + 0.5) * std::numbers::pi / static_cast<double>(height);
+            double const phi = (s + 0.5) * 2.0 * std::numbers::pi / static_cast<double>(width);
+            return { std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) };
+        }
+        case layout::octahedral:
+        {
+            double u = (s + 0.5) * 2.0 / static_cast<double>(width) - 1.0;
+            double v = (t + 0.5) * 2.0 / static_cast<double>(height) - 1.0;
+            fold_octahedral(u, v);
+            double const z = 1.0 - std::abs(u) - std::abs(v);
+            if (z < 0.0)
+                return normalize(std::copysign(1.0 - std::abs(v), u), std::copysign(1.0 - std::abs(u), v), z);
+            return normalize(u, v, z);
+        }
+        default:
+        {
+            cube_face const& f = cube_faces[face];
+            double const u = (s + 0.5) * 2.0 / static_cast<double>(width) - 1.0;
+            double const v = (t + 0.5) * 2.0 / static_cast<double>(height) - 1.0;
+            return normalize(f.axis[0] + u * f.right[0] + v * f.up[0], f.axis[1] + u * f.right[1] + v * f.up[1],
+                f.axis[2] + u * f.right[2] + v * f.up[2]);
+        }
+    }
+}
+
+/**
+ * Face and coordinates u, v in [-1, 1] over the face of a unit vector; free of
+ * branches, so batches vectorize
+ */
+template<layout Kind, typename Float>
+void face_coordinates(Float const x, Float const y, Float const z, Float& face, Float& u, Float& v)
+{
+    using Math = batch_math<Float>;
+    Float constexpr pi = std::numbers::pi_v<Float>;
+
+    if constexpr (Kind == layout::equirectangular)
+    {
+        Float const phi = Math::atan2(y, x);
+        face = 0;
+        u = (phi < 0 ? phi + 2 * pi : phi) / pi - 1;
+        v = Math::atan2(Math::sqrt(x * x + y * y), z) * 2 / pi - 1;
+    }
+    else if constexpr (Kind == layout::octahedral)
+    {
+        Float const l1 = std::abs(x) + std::abs(y) + std::abs(z);
+        Float const px = x / l1, py = y / l1;
+        face = 0;
+        u = z < 0 ? std::copysign(1 - std::abs(py), px) : px;
+        v = z < 0 ? std::copysign(1 - std::abs(px), py) : py;
+    }
+    else
+    {
+        Float const ax = std::abs(x), ay = std::abs(y), az = std::abs(z);
+        bool const x_major = (ax >= ay) & (ax >= az);
+        bool const y_major = !x_major & (ay >= az);
+        Float const major = x_major ? x : (y_major ? y : z);
+        face = (x_major ? Float(0) : (y_major ? Float(2) : Float(4))) + (major < 0 ? Float(1) : Float(0));
+        u = (x_major ? y : (y_major ? z : x)) / std::abs(major);
+        v = (x_major ? z : (y_major ? x : y)) / std::abs(major);
+    }
+}
+
+// Catmull-Rom weights of the four texels around a fraction f
+template<typename Float>
+std::array<Float, 4> catmull_rom(Float const f)
+{
+    return {
+        ((-f + 2) * f - 1) * f / 2,
+        ((3 * f - 5) * f * f + 2) / 2,
+        ((-3 * f + 4) * f + 1) * f / 2,
+        (f - 1) * f * f / 2
+    };
+}
+
+/**
+ * Interpolate a face at continuous texel coordinates (s, r), texel centers at
+ * integers
+ */
+template<typename Float>
+Float interpolate(tabulated<Float> const& t, std::size_t const face, Float const s, Float const r,
+    interpolation const mode)
+{
+    // s, r >= -1/2, so truncation of s + 1 floors without a libm call
+    std::ptrdiff_t const c = static_cast<std::ptrdiff_t>(s + 1) - 1;
+    std::ptrdiff_t const row = static_cast<std::ptrdiff_t>(r + 1) - 1;
+    Float const a = s - static_cast<Float>(c), b = r - static_cast<Float>(row);
+    Float const* texels = t.texels.data() + face * t.face_size;
+
+    if (mode == interpolation::bilinear)
+    {
+        std::size_t const r0 = t.row_offset(row), r1 = t.row_offset(row + 1);
+        std::size_t const c0 = t.column_offset(c), c1 = t.column_offset(c + 1);
+        Float const top = texels[r0 + c0] + a * (texels[r0 + c1] - texels[r0 + c0]);
+        Float const bottom = texels[r1 + c0] + a * (texels[r1 + c1] - texels[r1 + c0]);
+        return top + b * (bottom - top);
+    }
+
+    std::array<Float, 4> const ws = catmull_rom(a), wr = catmull_rom(b);
+    std::array<std::size_t, 4> columns;
+    for (std::ptrdiff_t j = 0; j < 4; ++j)
+        columns[j] = t.column_offset(c - 1 + j);
+
+    Float sum = 0;
+    for (std::ptrdiff_t i = 0; i < 4; ++i)
+    {
+        Float const* line = texels + t.row_offset(row - 1 + i);
+        sum += wr[i] * (ws[0] * line[columns[0]] + ws[1] * line[columns[1]] +
+            ws[2] * line[columns[2]] + ws[3] * line[columns[3]]);
+    }
+    return sum;
+}
+
+/**
+ * Interpolate a table at face coordinates, clamped to the outer halves of the
+ * border texels
+ */
+template<typename Float>
+Float interpolate_face(tabulated<Float> const& t, Float const face, Float const u, Float const v,
+    interpolation const mode)
+{
+    Float const width = static_cast<Float>(t.width), height = static_cast<Float>(t.height);
+    Float const s = std::clamp((u + 1) * width / 2 - Float(0.5), Float(-0.5), width - Float(0.5));
+    Float const r = std::clamp((v + 1) * height / 2 - Float(0.5), Float(-0.5), height - Float(0.5));
+    return interpolate(t, static_cast<std::size_t>(static_cast<int>(face)), s, r, mode);
+}
+
+template<layout Kind, typename Float>
+void lookup_layout(tabulated<Float> const& t, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> out, interpolation const mode)
+{
+    std::size_t constexpr block = 256;
+    std::array<Float, block> face, u, v;
+
+    // face coordinates by the vectorized kernels in blocks, then the gathers
+    for (std::size_t first = 0; first < x.size(); first += block)
+    {
+        std::size_t const count = std::min(block, x.size() - first);
+        eval_batch_xyz3_simd<Float, face_coordinates<Kind, Float>>(x.subspan(first, count), y.subspan(first, count),
+            z.subspan(first, count), face, u, v);
+
+        for (std::size_t i = 0; i < count; ++i)
+            out[first + i] = interpolate_face(t, face[i], u[i], v[i], mode);
+    }
+}
+
+/**
+ * Evaluate the function at rows of texel coordinates of every face, one row
+ * per parallel item; position(face, row, k) gives the coordinates of the k-th
+ * point of a row and store(face, row, k, value) consumes its value
+ */
+template<typename Float, typename Position, typename Store>
+void evaluate_rows(tabulated<Float> const& t, std::ptrdiff_t const first_row, std::size_t const rows,
+    std::size_t const count, Position&& position, Store&& store)
+{
+    batch_function_xyz<Float> const fn = get_batch_function_xyz<Float>(t.id);
+    parallel_for(t.faces * rows, 0, false, [&](std::size_t const item, unsigned)
+    {
+        std::size_t const face = item / rows;
+        std::ptrdiff_t const row = first_row + static_cast<std::ptrdiff_t>(item % rows);
+        std::vector<Float> x(count), y(count), z(count), values(count);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            auto const [s, r] = position(face, row, k);
+            auto const d = texel_direction(t.kind, t.width, t.height, face, s, r);
+            x[k] = static_cast<Float>(d[0]);
+            y[k] = static_cast<Float>(d[1]);
+            z[k] = static_cast<Float>(d[2]);
+        }
+        fn(x, y, z, values);
+        for (std::size_t k = 0; k < count; ++k)
+            store(face, row, k, values[k]);
+    });
+}
+
+} // namespace
+
+/**
+ * Sample a function onto a table
+ *
+ * The maximum interpolation errors are measured against the function at nine
+ * points of every cell between texel centers, where the leading error terms of
+ * both schemes peak. For smooth functions that is within a few percent of the
+ * largest error anywhere in the cell; across jumps it is only a sample.
+ *
+ * @param id The identifier of the function
+ * @param kind Grid layout
+ * @param resolution Texel rows per face, see layout
+ * @return The table
+ */
+template<typename Float>
+tabulated<Float> make_table(FunctionId const id, layout const kind, std::size_t const resolution)
+{
+    if (resolution == 0)
+        throw std::invalid_argument("table resolution must be positive");
+
+    using tab = tabulated<Float>;
+    tab t{};
+    t.id = id;
+    t.kind = kind;
+    t.height = resolution;
+    t.width = kind == layout::equirectangular ? 2 * resolution : resolution;
+    t.faces = kind == layout::cubemap ? 6 : 1;
+    std::size_t const padded_width = t.width + 2 * tab::apron;
+    std::size_t const padded_height = t.height + 2 * tab::apron;
+    t.tiles_across = (padded_width + tab::tile - 1) / tab::tile;
+    t.face_size = t.tiles_across * ((padded_height + tab::tile - 1) / tab::tile) * tab::tile * tab::tile;
+    t.texels.assign(t.faces * t.face_size, Float(0));
+
+    std::ptrdiff_t const apron = static_cast<std::ptrdiff_t>(tab::apron);
+    evaluate_rows(t, -apron, padded_height, padded_width,
+        [&](std::size_t, std::ptrdiff_t const row, std::size_t const k)
+        {
+            return std::pair<double, double>(static_cast<double>(static_cast<std::ptrdiff_t>(k) - apron),
+                static_cast<double>(row));
+        },
+        [&](std::size_t const face, std::ptrdiff_t const row, std::size_t const k, Float const value)
+        {
+            t.texels[t.index(face, row, static_cast<std::ptrdiff_t>(k) - apron)] = value;
+        });
+
+    // errors at (c + a, r + b) for a, b in offsets, one row of texels per item;
+    // bilinear is farthest off at the corner (c + 1/2, r + 1/2), but there the
+    // Catmull-Rom weights reduce to cubic Lagrange interpolation. Its leading
+    // error term, proportional to t (1 - t) (1 - 2t), peaks at 1/2 -+ 1 / (2 sqrt 3).
+    double constexpr offsets[] = { 0.5 - 0.5 / std::numbers::sqrt3, 0.5, 0.5 + 0.5 / std::numbers::sqrt3 };
+    std::vector<double> bilinear(t.faces * t.height, 0.0), bicubic(t.faces * t.height, 0.0);
+    for (double const a : offsets)
+    {
+        for (double const b : offsets)
+        {
+            evaluate_rows(t, 0, t.height, t.width,
+                [=](std::size_t, std::ptrdiff_t const row, std::size_t const k)
+                {
+                    return std::pair<double, double>(static_cast<double>(k) + a, static_cast<double>(row) + b);
+                },
+                [&](std::size_t const face, std::ptrdiff_t const row, std::size_t const k, Float const value)
+                {
+                    Float const s = static_cast<Float>(static_cast<double>(k) + a);
+                    Float const r = static_cast<Float>(static_cast<double>(row) + b);
+                    std::size_t const slot = face * t.height + static_cast<std::size_t>(row);
+                    bilinear[slot] = std::max(bilinear[slot],
+                        std::abs(static_cast<double>(interpolate(t, face, s, r, interpolation::bilinear) - value)));
+                    bicubic[slot] = std::max(bicubic[slot],
+                        std::abs(static_cast<double>(interpolate(t, face, s, r, interpolation::bicubic) - value)));
+                });
+        }
+    }
+    t.max_error_bilinear = *std::max_element(bilinear.begin(), bilinear.end());
+    t.max_error_bicubic = *std::max_element(bicubic.begin(), bicubic.end());
+    return t;
+}
+
+template<typename Float>
+tabulated<Float> make_table(std::string_view const id, layout const kind, std::size_t const resolution)
+{
+    return make_table<Float>(function_id(id), kind, resolution);
+}
+
+/**
+ * Get a cached table
+ *
+ * Each (id, layout, resolution) is sampled once per process and shared.
+ *
+ * @return Shared immutable table
+ */
+template<typename Float>
+std::shared_ptr<tabulated<Float> const> get_table(FunctionId const id, layout const kind, std::size_t const resolution)
+{
+    static std::mutex mutex;
+    static std::map<std::tuple<FunctionId, layout, std::size_t>, std::shared_ptr<tabulated<Float> const>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[{ id, kind, resolution }];
+    if (!entry)
+        entry = std::make_shared<tabulated<Float> const>(make_table<Float>(id, kind, resolution));
+    return entry;
+}
+
+/**
+ * Interpolate a table at a direction
+ *
+ * @param t Table
+ * @param x, y, z Unit vector
+ * @param mode Interpolation scheme
+ * @return Interpolated function value
+ */
+template<typename Float>
+Float lookup(tabulated<Float> const& t, Float const x, Float const y, Float const z,
+    interpolation const mode = interpolation::bilinear)
+{
+    Float face, u, v;
+    switch (t.kind)
+    {
+        case layout::equirectangular:
+            face_coordinates<layout::equirectangular>(x, y, z, face, u, v);
+            break;
+        case layout::octahedral:
+            face_coordinates<layout::octahedral>(x, y, z, face, u, v);
+            break;
+        default:
+            face_coordinates<layout::cubemap>(x, y, z, face, u, v);
+            break;
+    }
+    return interpolate_face(t, face, u, v, mode);
+}
+
+/**
+ * Interpolate a table at many directions
+ *
+ * @param t Table
+ * @param x, y, z Unit vector components, all of the same size
+ * @param out Interpolated values, at least as large as x
+ * @param mode Interpolation scheme
+ */
+template<typename Float>
+void lookup_batch(tabulated<Float> const& t, std::span<Float const> x, std::span<Float const> y,
+    std::span<Float const> z, std::span<Float> out, interpolation const mode = interpolation::bilinear)
+{
+    assert(y.size() == x.size() && z.size() == x.size() && out.size() >= x.size());
+
+    switch (t.kind)
+    {
+        case layout::equirectangular:
+            lookup_layout<layout::equirectangular>(t, x, y, z, out, mode);
+            break;
+        case layout::octahedral:
+            lookup_layout<layout::octahedral>(t, x, y, z, out, mode);
+            break;
+        default:
+            lookup_layout<layout::cubemap>(t, x, y, z, out, mode);
+            break;
+    }
+}
+
+namespace
+{
+
+inline constexpr char table_magic[8] = { 'S', 'P', 'H', 'C', 'T', 'A', 'B', 'L' };
+inline constexpr std::uint32_t table_version = 1;
+
+template<typename T>
+void write_value(std::ostream& out, T const value)
+{
+    out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template<typename T>
+T read_value(std::istream& in)
+{
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+        throw std::runtime_error("truncated table");
+    return value;
+}
+
+} // namespace
+
+/**
+ * Write a table in native byte order
+ *
+ * @param t Table
+ * @param out Binary stream
+ */
+template<typename Float>
+void save(tabulated<Float> const& t, std::ostream& out)
+{
+    out.write(table_magic, sizeof(table_magic));
+    write_value<std::uint32_t>(out, table_version);
+    write_value<std::uint32_t>(out, sizeof(Float));
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(t.id));
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(t.kind));
+    write_value<std::uint64_t>(out, t.height);
+    write_value<double>(out, t.max_error_bilinear);
+    write_value<double>(out, t.max_error_bicubic);
+    write_value<std::uint64_t>(out, t.texels.size());
+    out.write(reinterpret_cast<char const*>(t.texels.data()), static_cast<std::streamsize>(t.texels.size() * sizeof(Float)));
+    if (!out)
+        throw std::runtime_error("cannot write table");
+}
+
+/**
+ * Read a table written by save
+ *
+ * @param in Binary stream
+ * @return The table
+ * @throws std::runtime_error for a foreign, truncated or mismatching stream
+ */
+template<typename Float>
+tabulated<Float> load(std::istream& in)
+{
+    char magic[sizeof(table_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, table_magic, sizeof(magic)) != 0)
+        throw std::runtime_error("not a table");
+    if (read_value<std::uint32_t>(in) != table_version)
+        throw std::runtime_error("unsupported table version");
+    if (read_value<std::uint32_t>(in) != sizeof(Float))
+        throw std::runtime_error("table has a different floating point type");
+
+    std::uint32_t const id = read_value<std::uint32_t>(in);
+    std::uint32_t const kind = read_value<std::uint32_t>(in);
+    std::uint64_t const resolution = read_value<std::uint64_t>(in);
+    if (id >= function_count || kind > static_cast<std::uint32_t>(layout::cubemap) || resolution == 0)
+        throw std::runtime_error("corrupt table header");
+
+    // the geometry follows from the header; the texels are read, not sampled
+    tabulated<Float> t{};
+    t.id = static_cast<FunctionId>(id);
+    t.kind = static_cast<layout>(kind);
+    t.height = resolution;
+    t.width = t.kind == layout::equirectangular ? 2 * resolution : resolution;
+    t.faces = t.kind == layout::cubemap ? 6 : 1;
+    t.tiles_across = (t.width + 2 * tabulated<Float>::apron + tabulated<Float>::tile - 1) / tabulated<Float>::tile;
+    t.face_size = t.tiles_across * ((t.height + 2 * tabulated<Float>::apron + tabulated<Float>::tile - 1) /
+        tabulated<Float>::tile) * tabulated<Float>::tile * tabulated<Float>::tile;
+    t.max_error_bilinear = read_value<double>(in);
+    t.max_error_bicubic = read_value<double>(in);
+
+    if (read_value<std::uint64_t>(in) != t.faces * t.face_size)
+        throw std::runtime_error("corrupt table size");
+    t.texels.resize(t.faces * t.face_size);
+    if (!in.read(reinterpret_cast<char*>(t.texels.data()), static_cast<std::streamsize>(t.texels.size() * sizeof(Float))))
+        throw std::runtime_error("truncated table");
+    return t;
+}
+
+} // namespace table
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_TABLE_H
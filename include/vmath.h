@@ -0,0 +1,571 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+#ifndef SPHERICAL_COLLECTION_VMATH_H
+#define SPHERICAL_COLLECTION_VMATH_H
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace sphc
+{
+
+/**
+ * Branchless elementary functions
+ *
+ * Every function is a straight sequence of arithmetic, integer bit operations
+ * and selects over a single lane, with no conversion between floating point
+ * and integers, so a loop calling them is vectorized by the compiler for SSE4.2
+ * and above (checked per kernel by the check_vectorization target). The x86-64
+ * baseline has no 64-bit integer masks from double comparisons, so the generic
+ * double kernels vectorize only where they do not select. Accuracy is within a
+ * few ulp of the standard library over the argument ranges used by the
+ * collection (|x| < 1e4 for sin/cos).
+ */
+namespace vmath
+{
+
+namespace
+{
+
+template<typename Float>
+struct float_traits;
+
+template<>
+struct float_traits<float>
+{
+    using int_type = std::int32_t;
+    using uint_type = std::uint32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int exponent_bias = 127;
+    static constexpr float exp_min = -87.0f;
+    static constexpr float exp_max = 88.0f;
+};
+
+template<>
+struct float_traits<double>
+{
+    using int_type = std::int64_t;
+    using uint_type = std::uint64_t;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int exponent_bias = 1023;
+    static constexpr double exp_min = -708.0;
+    static constexpr double exp_max = 709.0;
+};
+
+template<typename Float, std::size_t N, std::size_t... I>
+Float polevl(Float const x, std::array<Float, N> const& c, std::index_sequence<I...>)
+{
+    Float r = c[0];
+    ((r = r * x + c[I + 1]), ...);
+    return r;
+}
+
+// Horner evaluation, unrolled at compile time so kernels stay a single loop
+template<typename Float, std::size_t N>
+Float polevl(Float const x, std::array<Float, N> const& c)
+{
+    return polevl(x, c, std::make_index_sequence<N - 1>{});
+}
+
+// Bitwise select; both operands are always computed, so the loop stays free of
+// control flow even where the compiler may not speculate floating point ops
+template<typename Float>
+Float select(bool const mask, Float const a, Float const b)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    uint_type const m = uint_type(0) - uint_type(mask);
+    return std::bit_cast<Float>((std::bit_cast<uint_type>(a) & m) | (std::bit_cast<uint_type>(b) & ~m));
+}
+
+// Round to nearest integer, valid for |x| < 2^(mantissa_bits - 1)
+//
+// The low bits of x + magic hold the integer in two's complement. The kernels
+// take the quadrant and the exponent from there, because x86 has no vector
+// conversion from double to a 64-bit integer below AVX-512DQ and a cast would
+// keep the double loops scalar.
+template<typename Float>
+Float round_nearest(Float const x, typename float_traits<Float>::uint_type& bits)
+{
+    Float constexpr magic = Float(3) * Float(std::int64_t(1) << (float_traits<Float>::mantissa_bits - 1));
+    Float const shifted = x + magic;
+    bits = std::bit_cast<typename float_traits<Float>::uint_type>(shifted);
+    return shifted - magic;
+}
+
+// 2^n for the bits of round_nearest of an integral n within the normal
+// exponent range; the shift drops everything above the exponent field
+template<typename Float>
+Float exp2_int(typename float_traits<Float>::uint_type const bits)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    return std::bit_cast<Float>((bits + uint_type(float_traits<Float>::exponent_bias))
+        << float_traits<Float>::mantissa_bits);
+}
+
+// Sine and cosine of r + q pi / 2 from those of r, by integer masks only,
+// which SSE2 has for 64-bit lanes unlike the 64-bit comparisons
+template<typename Float>
+void apply_quadrant(typename float_traits<Float>::uint_type const q, Float const ps, Float const pc, Float& s,
+    Float& c)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    int constexpr to_sign = static_cast<int>(sizeof(Float)) * 8 - 2;
+
+    uint_type const swap = uint_type(0) - (q & 1);
+    uint_type const bs = std::bit_cast<uint_type>(ps), bc = std::bit_cast<uint_type>(pc);
+    uint_type const s0 = (bc & swap) | (bs & ~swap);
+    uint_type const c0 = (bs & swap) | (bc & ~swap);
+    s = std::bit_cast<Float>(s0 ^ ((q & 2) << to_sign));
+    c = std::bit_cast<Float>(c0 ^ (((q + 1) & 2) << to_sign));
+}
+
+// Sign bit of x in place, by integer masks only, so a negative zero keeps it
+template<typename Float>
+typename float_traits<Float>::uint_type sign_bit(Float const x)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    return std::bit_cast<uint_type>(x) & (uint_type(1) << (sizeof(Float) * 8 - 1));
+}
+
+// a with the sign bit of x flipped in, for the odd functions at signed zeros
+template<typename Float>
+Float flip_sign(Float const a, Float const x)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    return std::bit_cast<Float>(std::bit_cast<uint_type>(a) ^ sign_bit(x));
+}
+
+// Four-quadrant correction of a = atan(y / x), from the sign bits so signed
+// zeros land where std::atan2 puts them: pi where x has its sign bit set, and
+// zero otherwise, with the sign of y. Two zero arguments divide to a NaN and
+// take the correction alone.
+template<typename Float>
+Float atan2_quadrant(Float const a, Float const y, Float const x)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    int constexpr to_low = static_cast<int>(sizeof(Float)) * 8 - 1;
+
+    Float constexpr pi = Float(3.14159265358979323846);
+    uint_type const negative_x = uint_type(0) - (sign_bit(x) >> to_low);
+    Float const offset = std::bit_cast<Float>((std::bit_cast<uint_type>(pi) & negative_x) | sign_bit(y));
+    return select(x == Float(0) && y == Float(0), offset, a + offset);
+}
+
+} // namespace
+
+/**
+ * Square root of a non-negative argument
+ *
+ * Newton iteration on the reciprocal square root from a bit-level initial
+ * guess. Unlike std::sqrt it has no errno path, which would otherwise put a
+ * conditional libm call into the loop and keep it scalar.
+ */
+template<typename Float>
+Float sqrt(Float const x)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+    uint_type constexpr magic = std::is_same_v<Float, float> ? uint_type(0x5f3759df) : uint_type(0x5fe6eb50c7b537a9);
+
+    Float r = std::bit_cast<Float>(magic - (std::bit_cast<uint_type>(x) >> 1));
+    r = r * (Float(1.5) - Float(0.5) * x * r * r);
+    r = r * (Float(1.5) - Float(0.5) * x * r * r);
+    r = r * (Float(1.5) - Float(0.5) * x * r * r);
+    if constexpr (std::is_same_v<Float, double>)
+        r = r * (Float(1.5) - Float(0.5) * x * r * r);
+
+    Float const s = x * r;
+    return s + Float(0.5) * (x - s * s) * r;
+}
+
+/**
+ * Sine and cosine with a shared argument reduction
+ */
+template<typename Float>
+void sincos(Float const x, Float& s, Float& c)
+{
+    using uint_type = typename float_traits<Float>::uint_type;
+
+    uint_type q;
+    Float const n = round_nearest(x * Float(0.63661977236758134308), q);
+    Float r;
+    if constexpr (std::is_same_v<Float, float>)
+        r = ((x - n * 1.5703125f) - n * 4.837512969970703125e-4f) - n * 7.549789948768648e-8f;
+    else
+        r = ((x - n * 1.57079632673412561417e+00) - n * 6.07710050630396597660e-11) - n * 2.02226624871116645580e-21;
+
+    Float const z = r * r;
+    Float ps, pc;
+    if constexpr (std::is_same_v<Float, float>)
+    {
+        ps = r + r * z * polevl(z, std::array<float, 3>{ -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f });
+        pc = 1.0f - 0.5f * z + z * z * polevl(z, std::array<float, 3>{
+            2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f });
+    }
+    else
+    {
+        ps = r + r * z * polevl(z, std::array<double, 6>{
+            1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+            -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1 });
+        pc = 1.0 - 0.5 * z + z * z * polevl(z, std::array<double, 6>{
+            -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+            2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2 });
+    }
+
+    apply_quadrant(q, ps, pc, s, c);
+}
+
+template<typename Float>
+Float sin(Float const x)
+{
+    Float s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+template<typename Float>
+Float cos(Float const x)
+{
+    Float s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+/**
+ * Exponential, saturating to the smallest/largest normal power instead of 0/inf
+ */
+template<typename Float>
+Float exp(Float const x)
+{
+    Float const xc = select(x < float_traits<Float>::exp_min, float_traits<Float>::exp_min,
+                     select(x > float_traits<Float>::exp_max, float_traits<Float>::exp_max, x));
+    typename float_traits<Float>::uint_type bits;
+    Float const n = round_nearest(xc * Float(1.44269504088896340736), bits);
+
+    Float p;
+    if constexpr (std::is_same_v<Float, float>)
+    {
+        Float const r = (xc - n * 0.693359375f) + n * 2.12194440e-4f;
+        p = polevl(r, std::array<float, 6>{
+            1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f })
+            * r * r + r + 1.0f;
+    }
+    else
+    {
+        Float const r = (xc - n * 6.93145751953125e-1) - n * 1.42860682030941723212e-6;
+        p = polevl(r, std::array<double, 14>{
+            1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+            1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0 });
+    }
+
+    return p * exp2_int<Float>(bits);
+}
+
+/**
+ * Hyperbolic tangent
+ */
+template<typename Float>
+Float tanh(Float const x)
+{
+    Float const ax = std::abs(x);
+    Float const z = x * x;
+
+    Float small;
+    if constexpr (std::is_same_v<Float, float>)
+        small = x + x * z * polevl(z, std::array<float, 5>{
+            -5.70498872745e-3f, 2.06390887954e-2f, -5.37397155531e-2f, 1.33314422036e-1f, -3.33332819422e-1f });
+    else
+        small = x + x * z * polevl(z, std::array<double, 3>{
+            -9.64399179425052238628e-1, -9.92877231001918586564e1, -1.61468768441708447952e3 })
+            / polevl(z, std::array<double, 4>{
+            1.0, 1.12811678491632931402e2, 2.23548839060100448583e3, 4.84406305325125486048e3 });
+
+    Float const large = Float(1) - Float(2) / (exp(Float(2) * ax) + Float(1));
+    return select(ax < Float(0.625), small, select(x < Float(0), -large, large));
+}
+
+/**
+ * Arc tangent
+ */
+template<typename Float>
+Float atan(Float const x)
+{
+    Float const ax = std::abs(x);
+    bool const big = ax > Float(2.41421356237309504880);
+    bool const mid = ax > Float(0.41421356237309504880);
+
+    Float const xr = select(big, Float(-1) / ax, select(mid, (ax - Float(1)) / (ax + Float(1)), ax));
+    Float const z = xr * xr;
+
+    Float y, r;
+    if constexpr (std::is_same_v<Float, float>)
+    {
+        y = select(big, 1.5707963267948966f, select(mid, 0.7853981633974483f, 0.0f));
+        r = polevl(z, std::array<float, 4>{
+            8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f, -3.33329491539e-1f }) * z * xr + xr;
+    }
+    else
+    {
+        Float constexpr morebits = 6.123233995736765886130e-17;
+        y = select(big, 1.57079632679489661923 + morebits, select(mid, 0.78539816339744830962 + 0.5 * morebits, 0.0));
+        r = xr * z * polevl(z, std::array<double, 5>{
+            -8.750608600031904122785e-1, -1.615753718733365076637e1, -7.500855792314704667340e1,
+            -1.228866684490136173410e2, -6.485021904942025371773e1 })
+            / polevl(z, std::array<double, 6>{
+            1.0, 2.485846490142306297962e1, 1.650270098316988542046e2, 4.328810604912902668951e2,
+            4.853903996359136964868e2, 1.945506571482613964425e2 }) + xr;
+    }
+
+    return flip_sign(y + r, x);
+}
+
+/**
+ * Four-quadrant arc tangent of y / x, in [-pi, pi]
+ *
+ * Signed zeros are treated as std::atan2 treats them, so atan2(+-0, -0) is
+ * +-pi and atan2(+-y, +-0) is +-pi / 2.
+ */
+template<typename Float>
+Float atan2(Float const y, Float const x)
+{
+    return atan2_quadrant(atan(y / x), y, x);
+}
+
+/**
+ * Arc cosine, argument clamped to [-1, 1]
+ */
+template<typename Float>
+Float acos(Float const x)
+{
+    Float const xc = select(x < Float(-1), Float(-1), select(x > Float(1), Float(1), x));
+    return atan2(sqrt((Float(1) - xc) * (Float(1) + xc)), xc);
+}
+
+/**
+ * Reduced-precision variants for the fast_math policy
+ *
+ * Double arguments are evaluated with the single-precision minimax
+ * polynomials (in double arithmetic) and fewer Newton steps, which roughly
+ * halves the work per call for a relative error of at most a few 1e-8. The
+ * float functions already use these polynomials and are used as they are.
+ */
+namespace fast
+{
+
+template<typename Float>
+Float sqrt(Float const x)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return vmath::sqrt(x);
+    else
+    {
+        Float r = std::bit_cast<Float>(std::uint64_t(0x5fe6eb50c7b537a9) - (std::bit_cast<std::uint64_t>(x) >> 1));
+        r = r * (1.5 - 0.5 * x * r * r);
+        r = r * (1.5 - 0.5 * x * r * r);
+        Float const s = x * r;
+        return s + 0.5 * (x - s * s) * r;
+    }
+}
+
+template<typename Float>
+void sincos(Float const x, Float& s, Float& c)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        vmath::sincos(x, s, c);
+    else
+    {
+        std::uint64_t q;
+        Float const n = round_nearest(x * 0.63661977236758134308, q);
+        Float const r = (x - n * 1.57079632673412561417e+00) - n * 6.07710050650619224932e-11;
+        Float const z = r * r;
+
+        Float const ps = r + r * z * polevl(z, std::array<double, 3>{ -1.9515295891e-4, 8.3321608736e-3, -1.6666654611e-1 });
+        Float const pc = 1.0 - 0.5 * z + z * z * polevl(z, std::array<double, 3>{
+            2.443315711809948e-5, -1.388731625493765e-3, 4.166664568298827e-2 });
+
+        apply_quadrant(q, ps, pc, s, c);
+    }
+}
+
+template<typename Float>
+Float sin(Float const x)
+{
+    Float s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+template<typename Float>
+Float cos(Float const x)
+{
+    Float s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+template<typename Float>
+Float exp(Float const x)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return vmath::exp(x);
+    else
+    {
+        Float const xc = select(x < float_traits<double>::exp_min, float_traits<double>::exp_min,
+                         select(x > float_traits<double>::exp_max, float_traits<double>::exp_max, x));
+        std::uint64_t bits;
+        Float const n = round_nearest(xc * 1.44269504088896340736, bits);
+        Float const r = (xc - n * 6.93145751953125e-1) - n * 1.42860682030941723212e-6;
+        Float const p = polevl(r, std::array<double, 6>{
+            1.9875691500e-4, 1.3981999507e-3, 8.3334519073e-3, 4.1665795894e-2, 1.6666665459e-1, 5.0000001201e-1 })
+            * r * r + r + 1.0;
+        return p * exp2_int<double>(bits);
+    }
+}
+
+template<typename Float>
+Float tanh(Float const x)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return vmath::tanh(x);
+    else
+    {
+        Float const ax = std::abs(x);
+        Float const z = x * x;
+        Float const small = x + x * z * polevl(z, std::array<double, 5>{
+            -5.70498872745e-3, 2.06390887954e-2, -5.37397155531e-2, 1.33314422036e-1, -3.33332819422e-1 });
+        Float const large = 1.0 - 2.0 / (exp(2.0 * ax) + 1.0);
+        return select(ax < 0.625, small, select(x < 0.0, -large, large));
+    }
+}
+
+template<typename Float>
+Float atan(Float const x)
+{
+    if constexpr (std::is_same_v<Float, float>)
+        return vmath::atan(x);
+    else
+    {
+        Float const ax = std::abs(x);
+        bool const big = ax > 2.41421356237309504880;
+        bool const mid = ax > 0.41421356237309504880;
+
+        Float const xr = select(big, -1.0 / ax, select(mid, (ax - 1.0) / (ax + 1.0), ax));
+        Float const z = xr * xr;
+        Float const y = select(big, 1.57079632679489661923, select(mid, 0.78539816339744830962, 0.0));
+        Float const r = polevl(z, std::array<double, 4>{
+            8.05374449538e-2, -1.38776856032e-1, 1.99777106478e-1, -3.33329491539e-1 }) * z * xr + xr;
+
+        return flip_sign(y + r, x);
+    }
+}
+
+template<typename Float>
+Float atan2(Float const y, Float const x)
+{
+    return atan2_quadrant(atan(y / x), y, x);
+}
+
+template<typename Float>
+Float acos(Float const x)
+{
+    Float const xc = select(x < Float(-1), Float(-1), select(x > Float(1), Float(1), x));
+    return atan2(sqrt((Float(1) - xc) * (Float(1) + xc)), xc);
+}
+
+} // namespace fast
+
+} // namespace vmath
+
+/**
+ * Math policy forwarding to the C++ standard library
+ *
+ * GCC and Clang merge the sin and cos of one argument in sincos into a single
+ * libm sincos call.
+ */
+struct std_math
+{
+    template<typename Float> static Float sin(Float x) { return std::sin(x); }
+    template<typename Float> static Float cos(Float x) { return std::cos(x); }
+    template<typename Float> static void sincos(Float x, Float& s, Float& c) { s = std::sin(x); c = std::cos(x); }
+    template<typename Float> static Float exp(Float x) { return std::exp(x); }
+    template<typename Float> static Float tanh(Float x) { return std::tanh(x); }
+    template<typename Float> static Float atan(Float x) { return std::atan(x); }
+    template<typename Float> static Float atan2(Float y, Float x) { return std::atan2(y, x); }
+    template<typename Float> static Float acos(Float x) { return std::acos(x); }
+    template<typename Float> static Float sqrt(Float x) { return std::sqrt(x); }
+    template<typename Float> static Float abs(Float x) { return std::abs(x); }
+};
+
+/**
+ * Math policy using the branchless vmath functions, for vectorized kernels
+ */
+struct vector_math
+{
+    template<typename Float> static Float sin(Float x) { return vmath::sin(x); }
+    template<typename Float> static Float cos(Float x) { return vmath::cos(x); }
+    template<typename Float> static void sincos(Float x, Float& s, Float& c) { vmath::sincos(x, s, c); }
+    template<typename Float> static Float exp(Float x) { return vmath::exp(x); }
+    template<typename Float> static Float tanh(Float x) { return vmath::tanh(x); }
+    template<typename Float> static Float atan(Float x) { return vmath::atan(x); }
+    template<typename Float> static Float atan2(Float y, Float x) { return vmath::atan2(y, x); }
+    template<typename Float> static Float acos(Float x) { return vmath::acos(x); }
+    template<typename Float> static Float sqrt(Float x) { return vmath::sqrt(x); }
+    template<typename Float> static Float abs(Float x) { return std::abs(x); }
+};
+
+/**
+ * Math policy trading accuracy for speed, for workloads that tolerate about
+ * 1e-7 relative error
+ *
+ * Only double gains from it: its batch kernels run about 1.5x faster than
+ * with vector_math (1.1x to 2.4x across the collection with AVX2), not
+ * several times. Float arguments use the vector_math functions unchanged,
+ * which already are single-precision minimax polynomials, so float gets no
+ * speedup from this policy.
+ *
+ * Maximum errors over the argument ranges used by the collection, verified by
+ * tools/accuracy (target check_fast_math):
+ *                   double          float
+ *   sin, cos        3e-9            2e-7 absolute (|x| < 1e4)
+ *   exp             2e-9            2e-7 relative
+ *   tanh            5e-9            3e-7 relative
+ *   atan            3e-8            4e-7 relative
+ *   atan2           3e-8            5e-7 relative
+ *   acos            3e-8            5e-7 relative
+ *   sqrt            1e-10           2e-7 relative
+ * The collection functions evaluated with it stay within 1e-6 (double) and
+ * 5e-5 (float) of std_math, relative to max(|f|, 1).
+ */
+struct fast_math
+{
+    template<typename Float> static Float sin(Float x) { return vmath::fast::sin(x); }
+    template<typename Float> static Float cos(Float x) { return vmath::fast::cos(x); }
+    template<typename Float> static void sincos(Float x, Float& s, Float& c) { vmath::fast::sincos(x, s, c); }
+    template<typename Float> static Float exp(Float x) { return vmath::fast::exp(x); }
+    template<typename Float> static Float tanh(Float x) { return vmath::fast::tanh(x); }
+    template<typename Float> static Float atan(Float x) { return vmath::fast::atan(x); }
+    template<typename Float> static Float atan2(Float y, Float x) { return vmath::fast::atan2(y, x); }
+    template<typename Float> static Float acos(Float x) { return vmath::fast::acos(x); }
+    template<typename Float> static Float sqrt(Float x) { return vmath::fast::sqrt(x); }
+    template<typename Float> static Float abs(Float x) { return std::abs(x); }
+};
+
+/**
+ * Policy used by the batch kernels: vmath has kernels for float and double
+ * only, other types (long double) fall back to the standard library
+ */
+template<typename Float>
+using batch_math = std::conditional_t<std::is_same_v<Float, float> || std::is_same_v<Float, double>,
+    vector_math, std_math>;
+
+} // namespace sphc
+
+#endif // SPHERICAL_COLLECTION_VMATH_H
@@ -0,0 +1,236 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Accuracy of the fast_math policy
+ *
+ * Measures the maximum error of every vmath::fast function against the long
+ * double standard library, and of every collection function evaluated by the
+ * fast_math batch kernels against the scalar std_math path of the same type,
+ * in double and in float. Unit vectors with signed zero coordinates, where
+ * atan2 picks its quadrant from the sign bits, are compared for the
+ * vector_math kernels as well. Exits with a non-zero status if any error
+ * exceeds the bounds documented at fast_math.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+#include <type_traits>
+
+#include <functions.h>
+
+namespace
+{
+
+template<typename Float>
+struct elementary
+{
+    char const* name;
+    Float (*fast)(Float);
+    long double (*exact)(long double);
+    double lo, hi;
+    bool relative;
+    double bound;               // as documented at fast_math
+};
+
+template<typename Float>
+char const* type_name()
+{
+    return std::is_same_v<Float, float> ? "float" : "double";
+}
+
+template<typename Float>
+double measure(elementary<Float> const& e)
+{
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> u(e.lo, e.hi);
+
+    double worst = 0.0;
+    for (int i = 0; i < 1000000; ++i)
+    {
+        Float const x = static_cast<Float>(u(rng));
+        long double const exact = e.exact(x);
+        long double const diff = std::abs(static_cast<long double>(e.fast(x)) - exact);
+        long double const scale = e.relative ? std::abs(exact) : 1.0L;
+        if (scale > 0)
+            worst = std::max(worst, static_cast<double>(diff / scale));
+    }
+    return worst;
+}
+
+template<typename Float, std::size_t N>
+int check_elementary(elementary<Float> const (&functions)[N])
+{
+    int failures = 0;
+    std::printf("elementary functions (%s)\n", type_name<Float>());
+    for (elementary<Float> const& e : functions)
+    {
+        double const error = measure(e);
+        bool const ok = error <= e.bound;
+        std::printf("  %s  %-6s %s error %.3g (bound %.0g)\n", ok ? "ok  " : "FAIL", e.name,
+            e.relative ? "relative" : "absolute", error, e.bound);
+        failures += ok ? 0 : 1;
+    }
+    return failures;
+}
+
+// collection functions, error relative to max(|f|, 1)
+template<typename Float>
+int check_collection(double const bound)
+{
+    using namespace sphc;
+
+    std::size_t constexpr n = 1 << 18;
+    std::vector<Float> theta(n), phi(n), values(n);
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        theta[i] = static_cast<Float>(std::acos(1.0 - 2.0 * u(rng)));
+        phi[i] = static_cast<Float>(2.0 * std::numbers::pi * u(rng));
+    }
+
+    int failures = 0;
+    std::printf("collection functions (%s, fast_math batch against std_math, bound %.0g)\n", type_name<Float>(),
+        bound);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        eval_batch<Float, fast_math>(id, theta, phi, values);
+
+        double worst = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double const exact = eval_function<Float>(id, theta[i], phi[i]);
+            worst = std::max(worst, std::abs(values[i] - exact) / std::max(std::abs(exact), 1.0));
+        }
+
+        // the discontinuous functions may flip at points within rounding of the jump
+        bool const ok = worst <= bound || (id >= FunctionId::d1 && id <= FunctionId::d4);
+        std::printf("  %s  %s error %.3g\n", ok ? "ok  " : "FAIL", function_name(id).data(), worst);
+        failures += ok ? 0 : 1;
+    }
+    return failures;
+}
+
+// batch kernels of a policy against the scalar std_math path at the unit
+// vectors along the axes, with every sign of their zero coordinates
+template<typename Float, typename Math>
+double signed_zero_error(sphc::FunctionId const id)
+{
+    using namespace sphc;
+
+    std::vector<Float> x, y, z;
+    for (int axis = 0; axis < 3; ++axis)
+        for (Float const one : { Float(1), Float(-1) })
+            for (int signs = 0; signs < 4; ++signs)
+            {
+                Float c[3];
+                c[axis] = one;
+                c[(axis + 1) % 3] = signs & 1 ? Float(-0.0) : Float(0.0);
+                c[(axis + 2) % 3] = signs & 2 ? Float(-0.0) : Float(0.0);
+                x.push_back(c[0]);
+                y.push_back(c[1]);
+                z.push_back(c[2]);
+            }
+
+    std::vector<Float> values(x.size());
+    eval_batch_xyz<Float, Math>(id, x, y, z, values);
+    function_xyz<Float> const fn = get_function_xyz<Float>(id);
+
+    double worst = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        double const exact = fn(x[i], y[i], z[i]);
+        worst = std::max(worst, std::abs(values[i] - exact) / std::max(std::abs(exact), 1.0));
+    }
+    return worst;
+}
+
+template<typename Float>
+int check_signed_zeros(double const bound)
+{
+    using namespace sphc;
+
+    int failures = 0;
+    std::printf("signed zeros (%s, bound %.0g)\n", type_name<Float>(), bound);
+
+    // atan2 over the signs of zero and one, which must also match in sign
+    Float const arguments[] = { Float(0.0), Float(-0.0), Float(1), Float(-1) };
+    double vector = 0.0, fast = 0.0;
+    bool signs = true;
+    for (Float const y : arguments)
+        for (Float const x : arguments)
+        {
+            Float const exact = std::atan2(y, x), v = vmath::atan2(y, x), f = vmath::fast::atan2(y, x);
+            vector = std::max(vector, static_cast<double>(std::abs(v - exact)));
+            fast = std::max(fast, static_cast<double>(std::abs(f - exact)));
+            signs = signs && std::signbit(v) == std::signbit(exact) && std::signbit(f) == std::signbit(exact);
+        }
+    bool const ok = vector <= bound && fast <= bound && signs;
+    std::printf("  %s  atan2 error %.3g (vmath), %.3g (vmath::fast), signs %s\n", ok ? "ok  " : "FAIL", vector, fast,
+        signs ? "match" : "differ");
+    failures += ok ? 0 : 1;
+
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        double const v = signed_zero_error<Float, vector_math>(id);
+        double const e = signed_zero_error<Float, fast_math>(id);
+
+        // the discontinuous functions may flip at points within rounding of the jump
+        bool const function_ok = std::max(v, e) <= bound || (id >= FunctionId::d1 && id <= FunctionId::d4);
+        std::printf("  %s  %s error %.3g (vector_math), %.3g (fast_math)\n", function_ok ? "ok  " : "FAIL",
+            function_name(id).data(), v, e);
+        failures += function_ok ? 0 : 1;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    using namespace sphc;
+
+    elementary<double> const doubles[] =
+    {
+        { "sin", [](double x) { return vmath::fast::sin(x); }, [](long double x) { return std::sin(x); }, -1e4, 1e4, false, 3e-9 },
+        { "cos", [](double x) { return vmath::fast::cos(x); }, [](long double x) { return std::cos(x); }, -1e4, 1e4, false, 3e-9 },
+        { "exp", [](double x) { return vmath::fast::exp(x); }, [](long double x) { return std::exp(x); }, -80.0, 80.0, true, 2e-9 },
+        { "tanh", [](double x) { return vmath::fast::tanh(x); }, [](long double x) { return std::tanh(x); }, -20.0, 20.0, true, 5e-9 },
+        { "atan", [](double x) { return vmath::fast::atan(x); }, [](long double x) { return std::atan(x); }, -1e3, 1e3, true, 3e-8 },
+        { "atan2", [](double x) { return vmath::fast::atan2(std::sin(x), std::cos(x)); },
+            [](long double x) { return std::atan2(std::sin(x), std::cos(x)); }, -3.14, 3.14, true, 3e-8 },
+        { "acos", [](double x) { return vmath::fast::acos(x); }, [](long double x) { return std::acos(x); }, -1.0, 1.0, true, 3e-8 },
+        { "sqrt", [](double x) { return vmath::fast::sqrt(x); }, [](long double x) { return std::sqrt(x); }, 0.0, 1e3, true, 1e-10 },
+    };
+
+    elementary<float> const floats[] =
+    {
+        { "sin", [](float x) { return vmath::fast::sin(x); }, [](long double x) { return std::sin(x); }, -1e4, 1e4, false, 2e-7 },
+        { "cos", [](float x) { return vmath::fast::cos(x); }, [](long double x) { return std::cos(x); }, -1e4, 1e4, false, 2e-7 },
+        { "exp", [](float x) { return vmath::fast::exp(x); }, [](long double x) { return std::exp(x); }, -80.0, 80.0, true, 2e-7 },
+        { "tanh", [](float x) { return vmath::fast::tanh(x); }, [](long double x) { return std::tanh(x); }, -20.0, 20.0, true, 3e-7 },
+        { "atan", [](float x) { return vmath::fast::atan(x); }, [](long double x) { return std::atan(x); }, -1e3, 1e3, true, 4e-7 },
+        { "atan2", [](float x) { return vmath::fast::atan2(std::sin(x), std::cos(x)); },
+            [](long double x) { return std::atan2(std::sin(x), std::cos(x)); }, -3.14, 3.14, true, 5e-7 },
+        { "acos", [](float x) { return vmath::fast::acos(x); }, [](long double x) { return std::acos(x); }, -1.0, 1.0, true, 5e-7 },
+        { "sqrt", [](float x) { return vmath::fast::sqrt(x); }, [](long double x) { return std::sqrt(x); }, 0.0, 1e3, true, 2e-7 },
+    };
+
+    int failures = check_elementary(doubles) + check_elementary(floats);
+    failures += check_collection<double>(1e-6);
+    failures += check_collection<float>(5e-5);
+    failures += check_signed_zeros<double>(1e-6);
+    failures += check_signed_zeros<float>(5e-5);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the adaptive integrator
+ *
+ * Integrates every function of the collection and compares the estimate with
+ * the integrals table: a converged result must be within its estimated error,
+ * the analytic functions and the great circle jumps must converge within the
+ * budget, and the functions that are not smooth on every triangle must not be
+ * reported converged. The integrator of plain functions of (theta, phi) is
+ * checked on the analytic functions. Exits with a non-zero status if any check
+ * fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+
+#include <adaptive.h>
+
+int main()
+{
+    using namespace sphc;
+
+    adaptive::options opt;
+    opt.max_evaluations = 4'000'000;
+
+    int failures = 0;
+    std::printf("functions of the collection (tolerance %.0g, %zu evaluations)\n", opt.absolute_tolerance,
+        opt.max_evaluations);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        function_metadata const meta = get_metadata(id);
+        adaptive::result<double> const r = adaptive::integrate<double>(id, opt);
+        double const error = std::abs(r.estimate - get_integral<double>(id));
+
+        bool const great_circle = meta.discontinuities == discontinuity_set::plane &&
+            get_discontinuity_plane(id)->offset == 0.0;
+        bool const must_converge = meta.regularity == smoothness::analytic || great_circle;
+        bool const may_converge = must_converge || meta.regularity == smoothness::steep;
+
+        bool ok = true;
+        if (r.converged)
+            ok = may_converge && error <= r.error;
+        else
+            ok = !must_converge;
+        std::printf("  %s  %s error %.3g, estimated %.3g, %s\n", ok ? "ok  " : "FAIL", function_name(id).data(),
+            error, r.error, r.converged ? "converged" : "not converged");
+        failures += ok ? 0 : 1;
+    }
+
+    std::printf("functions of (theta, phi)\n");
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        if (get_metadata(id).regularity != smoothness::analytic)
+            continue;
+
+        adaptive::result<double> const r = adaptive::integrate<double>(get_function<double>(id), opt);
+        double const error = std::abs(r.estimate - get_integral<double>(id));
+        bool const ok = error <= std::max(r.error, 1e-10);
+        std::printf("  %s  %s error %.3g, estimated %.3g\n", ok ? "ok  " : "FAIL", function_name(id).data(), error,
+            r.error);
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the automatic differentiation
+ *
+ * For every function of the collection, the surface gradient and Hessian
+ * from differentiate must match central differences of the scalar function
+ * along great circles through random points, and the dispatched batch
+ * gradient kernels must agree with the scalar derivatives. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+
+#include <autodiff.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::size_t constexpr points = 4099;   // not a multiple of any vector width
+
+using vector3 = std::array<double, 3>;
+
+struct directions
+{
+    std::vector<double> x, y, z;
+    std::vector<vector3> tangent;       // unit, tangent at the point
+};
+
+// random points away from the poles, where the functions defined through angles are singular
+directions random_directions()
+{
+    std::mt19937_64 rng(6);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    directions d;
+    while (d.x.size() < points)
+    {
+        double const z = 1.0 - 2.0 * u(rng);
+        if (std::abs(z) > 0.99)
+            continue;
+        double const r = std::sqrt(1.0 - z * z);
+        double const phi = 2.0 * std::numbers::pi * u(rng);
+        double const angle = 2.0 * std::numbers::pi * u(rng);
+
+        // a rotation of the east and north directions by a random angle
+        vector3 const east = { -std::sin(phi), std::cos(phi), 0.0 };
+        vector3 const north = { -z * std::cos(phi), -z * std::sin(phi), r };
+        d.x.push_back(r * std::cos(phi));
+        d.y.push_back(r * std::sin(phi));
+        d.z.push_back(z);
+        vector3 t;
+        for (std::size_t k = 0; k < 3; ++k)
+            t[k] = std::cos(angle) * east[k] + std::sin(angle) * north[k];
+        d.tangent.push_back(t);
+    }
+    return d;
+}
+
+// f at distance s along the great circle through p in direction t
+double along(function_xyz<double> const& fn, vector3 const& p, vector3 const& t, double const s)
+{
+    double const c = std::cos(s), sn = std::sin(s);
+    return fn(c * p[0] + sn * t[0], c * p[1] + sn * t[1], c * p[2] + sn * t[2]);
+}
+
+} // namespace
+
+int main()
+{
+    double constexpr h1 = 1e-5;         // step of the first differences
+    double constexpr h2 = 1e-4;         // step of the second differences, and of the wider first ones
+    double constexpr gradient_bound = 1e-6;
+    double constexpr hessian_bound = 1e-4;
+    double constexpr batch_bound = 1e-12;
+
+    directions const d = random_directions();
+    std::vector<double> value(points), gx(points), gy(points), gz(points);
+
+    int failures = 0;
+    std::printf("%zu points, errors relative to max(|derivative|, 1) (bounds %.0g gradient, %.0g Hessian, %.0g batch)\n",
+        points, gradient_bound, hessian_bound, batch_bound);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        function_xyz<double> const fn = get_function_xyz<double>(id);
+        bool const analytic = get_metadata(id).regularity == smoothness::analytic;
+        autodiff::eval_with_gradient<double>(id, d.x, d.y, d.z, value, gx, gy, gz);
+
+        double gradient = 0.0, hessian = 0.0, batch = 0.0;
+        std::size_t skipped = 0;
+        for (std::size_t i = 0; i < points; ++i)
+        {
+            vector3 const p = { d.x[i], d.y[i], d.z[i] };
+            vector3 const& t = d.tangent[i];
+            autodiff::derivatives<double> const a = autodiff::differentiate<double>(id, p[0], p[1], p[2], true);
+
+            // the discontinuous functions may flip at points within rounding of the jump
+            if (id < FunctionId::d1 || id > FunctionId::d4)
+            {
+                batch = std::max({ batch, std::abs(value[i] - a.value) / std::max(std::abs(a.value), 1.0),
+                    std::abs(gx[i] - a.gradient[0]) / std::max(std::abs(a.gradient[0]), 1.0),
+                    std::abs(gy[i] - a.gradient[1]) / std::max(std::abs(a.gradient[1]), 1.0),
+                    std::abs(gz[i] - a.gradient[2]) / std::max(std::abs(a.gradient[2]), 1.0) });
+            }
+
+            double const f0 = fn(p[0], p[1], p[2]);
+            double const first = (along(fn, p, t, h1) - along(fn, p, t, -h1)) / (2.0 * h1);
+            double const wide = (along(fn, p, t, h2) - along(fn, p, t, -h2)) / (2.0 * h2);
+            double const second = (along(fn, p, t, h2) - 2.0 * f0 + along(fn, p, t, -h2)) / (h2 * h2);
+
+            // outside the analytic functions, a stencil crossing a jump or a kink shows in the two steps
+            if (!analytic && std::abs(first - wide) > 1e-5 * std::max(std::abs(first), 1.0))
+            {
+                ++skipped;
+                continue;
+            }
+
+            double const slope = a.gradient[0] * t[0] + a.gradient[1] * t[1] + a.gradient[2] * t[2];
+            auto const& m = a.hessian;      // xx, xy, xz, yy, yz, zz
+            double const curvature = m[0] * t[0] * t[0] + m[3] * t[1] * t[1] + m[5] * t[2] * t[2] +
+                2.0 * (m[1] * t[0] * t[1] + m[2] * t[0] * t[2] + m[4] * t[1] * t[2]);
+            gradient = std::max(gradient, std::abs(first - slope) / std::max(std::abs(slope), 1.0));
+            hessian = std::max(hessian, std::abs(second - curvature) / std::max(std::abs(curvature), 1.0));
+        }
+
+        bool const ok = gradient <= gradient_bound && hessian <= hessian_bound && batch <= batch_bound &&
+            skipped <= points / 50;
+        std::printf("  %s  %s gradient %.3g, Hessian %.3g, batch %.3g, %zu points at a jump or kink skipped\n",
+            ok ? "ok  " : "FAIL", function_name(id).data(), gradient, hessian, batch, skipped);
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
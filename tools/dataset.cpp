@@ -0,0 +1,195 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the dataset files
+ *
+ * Creates files of both coordinate layouts and precisions, evaluates them in
+ * parallel, and opens them again: the coordinates must read back unchanged
+ * and the values must match the scalar functions. Point sets without a
+ * function, read-only mappings, foreign files and files shorter than their
+ * header declares must be refused. The files are written to the temporary
+ * directory and removed. Exits with a non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <fstream>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <dataset.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::size_t constexpr count = 100003;          // neither a multiple of a cache line nor of a chunk
+
+template<typename Float>
+char const* type_name()
+{
+    return std::is_same_v<Float, float> ? "float" : "double";
+}
+
+template<typename Error, typename Fn>
+bool throws(Fn const& fn)
+{
+    try
+    {
+        fn();
+    }
+    catch (Error const&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int report(bool const ok, char const* what)
+{
+    std::printf("  %s  %s\n", ok ? "ok  " : "FAIL", what);
+    return ok ? 0 : 1;
+}
+
+// random points of the layout, in file column order
+template<typename Float>
+std::vector<std::vector<Float>> random_points(dataset::coordinates const layout)
+{
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::vector<Float>> columns(layout == dataset::coordinates::spherical ? 2 : 3,
+        std::vector<Float>(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double const theta = std::acos(1.0 - 2.0 * u(rng));
+        double const phi = 2.0 * std::numbers::pi * u(rng);
+        if (layout == dataset::coordinates::spherical)
+        {
+            columns[0][i] = static_cast<Float>(theta);
+            columns[1][i] = static_cast<Float>(phi);
+        }
+        else
+        {
+            auto const [x, y, z] = spherical_to_xyz(theta, phi);
+            columns[0][i] = static_cast<Float>(x);
+            columns[1][i] = static_cast<Float>(y);
+            columns[2][i] = static_cast<Float>(z);
+        }
+    }
+    return columns;
+}
+
+template<typename Float>
+int check_round_trip(std::string const& path, dataset::coordinates const layout, char const* name)
+{
+    FunctionId constexpr id = FunctionId::o3;
+    std::vector<std::vector<Float>> const points = random_points<Float>(layout);
+    std::printf("%s coordinates, %s\n", name, type_name<Float>());
+
+    {
+        dataset::file<Float> f = dataset::create<Float>(path, layout, count, id);
+        for (std::size_t k = 0; k < points.size(); ++k)
+            std::copy(points[k].begin(), points[k].end(), f.mutable_column(k).begin());
+        dataset::evaluate(f, 3);
+        f.sync();
+    }
+
+    dataset::file<Float> const f = dataset::open<Float>(path);
+    int failures = report(f.size() == count && f.layout() == layout && f.function() == id && !f.is_writable(),
+        "header reads back");
+
+    bool same = true;
+    for (std::size_t k = 0; k < points.size(); ++k)
+        same = same && std::equal(points[k].begin(), points[k].end(), f.column(k).begin());
+    failures += report(same, "coordinates read back unchanged");
+
+    // relative to max(|f|, 1), as the batch kernels are not the scalar functions
+    double worst = 0.0;
+    function<Float> const fn = get_function<Float>(id);
+    function_xyz<Float> const fn_xyz = get_function_xyz<Float>(id);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double const exact = layout == dataset::coordinates::spherical ? fn(points[0][i], points[1][i]) :
+            fn_xyz(points[0][i], points[1][i], points[2][i]);
+        worst = std::max(worst, std::abs(f.values()[i] - exact) / std::max(std::abs(exact), 1.0));
+    }
+    double const bound = std::is_same_v<Float, float> ? 1e-5 : 1e-12;
+    std::printf("  %s  values error %.3g (bound %.0g)\n", worst <= bound ? "ok  " : "FAIL", worst, bound);
+    failures += worst <= bound ? 0 : 1;
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    std::filesystem::path const directory = std::filesystem::temp_directory_path();
+    std::string const path = (directory / "sphc_check_dataset.bin").string();
+    std::string const other = (directory / "sphc_check_dataset_other.bin").string();
+
+    int failures = 0;
+    failures += check_round_trip<double>(path, dataset::coordinates::spherical, "spherical");
+    failures += check_round_trip<float>(path, dataset::coordinates::spherical, "spherical");
+    failures += check_round_trip<double>(path, dataset::coordinates::cartesian, "cartesian");
+    failures += check_round_trip<float>(path, dataset::coordinates::cartesian, "cartesian");
+
+    std::printf("refused operations\n");
+    failures += report(throws<std::logic_error>([&]()
+        {
+            dataset::file<float> f = dataset::open<float>(path);
+            f.mutable_values();
+        }), "writing a read-only mapping");
+    failures += report(throws<std::runtime_error>([&]() { dataset::open<double>(path); }),
+        "opening a float file as double");
+    {
+        dataset::file<double> points = dataset::create<double>(other, dataset::coordinates::cartesian, 10,
+            std::nullopt);
+        failures += report(!points.function() && throws<std::logic_error>([&]() { dataset::evaluate(points); }),
+            "evaluating a point set without a function");
+        failures += report(throws<std::out_of_range>([&]() { points.values(); }), "reading its missing values");
+    }
+    {
+        dataset::create<double>(other, dataset::coordinates::cartesian, 10, FunctionId::o3).sync();
+        std::filesystem::resize_file(other, std::filesystem::file_size(other) - sizeof(double));
+    }
+    failures += report(throws<std::runtime_error>([&]() { dataset::open<double>(other); }),
+        "opening a truncated file");
+    {
+        // four columns of 2^62 doubles wrap a 64-bit byte count to zero
+        std::uint64_t const huge = std::uint64_t(1) << 62;
+        std::fstream patch(other, std::ios::binary | std::ios::in | std::ios::out);
+        patch.seekp(offsetof(dataset::header, count));
+        patch.write(reinterpret_cast<char const*>(&huge), sizeof(huge));
+        patch.seekp(offsetof(dataset::header, stride));
+        patch.write(reinterpret_cast<char const*>(&huge), sizeof(huge));
+    }
+    failures += report(throws<std::runtime_error>([&]() { dataset::open<double>(other); }),
+        "opening a file with an oversized stride");
+    {
+        std::ofstream(other, std::ios::binary | std::ios::trunc) << "not a dataset, but long enough to hold a header "
+            "of sixty-four bytes";
+    }
+    failures += report(throws<std::runtime_error>([&]() { dataset::open<double>(other); }),
+        "opening a foreign file");
+    std::filesystem::remove(other);
+    failures += report(throws<std::system_error>([&]() { dataset::open<double>(other); }),
+        "opening a missing file");
+
+    std::filesystem::remove(path);
+    return failures == 0 ? 0 : 1;
+}
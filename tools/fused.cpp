@@ -0,0 +1,136 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the fused evaluators
+ *
+ * Every row of eval_fused and eval_fused_xyz must agree with eval_batch and
+ * eval_batch_xyz of its function, for all functions and for subsets of them
+ * in any order, over point counts below, at and across the tile size. Exits
+ * with a non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+#include <type_traits>
+
+#include <fused.h>
+
+namespace
+{
+
+using namespace sphc;
+
+template<typename Float>
+char const* type_name()
+{
+    return std::is_same_v<Float, float> ? "float" : "double";
+}
+
+template<typename Float>
+struct point_set
+{
+    std::vector<Float> theta, phi, x, y, z;
+};
+
+template<typename Float>
+point_set<Float> random_points(std::size_t const n)
+{
+    std::mt19937_64 rng(8);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    point_set<Float> p;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double const theta = std::acos(1.0 - 2.0 * u(rng));
+        double const phi = 2.0 * std::numbers::pi * u(rng);
+        auto const [x, y, z] = spherical_to_xyz(theta, phi);
+        p.theta.push_back(static_cast<Float>(theta));
+        p.phi.push_back(static_cast<Float>(phi));
+        p.x.push_back(static_cast<Float>(x));
+        p.y.push_back(static_cast<Float>(y));
+        p.z.push_back(static_cast<Float>(z));
+    }
+    return p;
+}
+
+// largest difference of the fused rows from the per-function kernels, relative to max(|f|, 1)
+template<typename Float>
+double fused_error(std::span<FunctionId const> ids, point_set<Float> const& p, bool const xyz)
+{
+    std::size_t const n = p.theta.size();
+    std::vector<Float> fused(ids.size() * n), single(n);
+    if (xyz)
+        eval_fused_xyz<Float>(ids, p.x, p.y, p.z, fused);
+    else
+        eval_fused<Float>(ids, p.theta, p.phi, fused);
+
+    double worst = 0.0;
+    for (std::size_t k = 0; k < ids.size(); ++k)
+    {
+        // the discontinuous functions may flip at points within rounding of the jump
+        if (ids[k] >= FunctionId::d1 && ids[k] <= FunctionId::d4)
+            continue;
+
+        if (xyz)
+            eval_batch_xyz<Float>(ids[k], p.x, p.y, p.z, single);
+        else
+            eval_batch<Float>(ids[k], p.theta, p.phi, single);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double const exact = single[i];
+            worst = std::max(worst, std::abs(fused[k * n + i] - exact) / std::max(std::abs(exact), 1.0));
+        }
+    }
+    return worst;
+}
+
+template<typename Float>
+int check(double const bound)
+{
+    using enum FunctionId;
+    struct
+    {
+        char const* name;
+        std::vector<FunctionId> ids;
+    } const subsets[] =
+    {
+        { "all functions", std::vector<FunctionId>(all_functions.begin(), all_functions.end()) },
+        { "azimuth only (o7, z1)", { o7, z1 } },
+        { "angles only (a2, o5)", { a2, o5 } },
+        { "mixed, out of order (z3, o6, d2, p1, z1, a1)", { z3, o6, d2, p1, z1, a1 } },
+        { "single (l2)", { l2 } },
+    };
+
+    int failures = 0;
+    std::printf("%s, fused rows against the per-function kernels (bound %.0g)\n", type_name<Float>(), bound);
+    for (std::size_t const n : { std::size_t(1), std::size_t(37), fused_tile, 3 * fused_tile + 101 })
+    {
+        point_set<Float> const p = random_points<Float>(n);
+        for (auto const& s : subsets)
+        {
+            double const angles = fused_error<Float>(s.ids, p, false);
+            double const vectors = fused_error<Float>(s.ids, p, true);
+            bool const ok = std::max(angles, vectors) <= bound;
+            std::printf("  %s  %zu points, %s: angles %.3g, unit vectors %.3g\n", ok ? "ok  " : "FAIL", n, s.name,
+                angles, vectors);
+            failures += ok ? 0 : 1;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int const failures = check<double>(1e-12) + check<float>(1e-5);
+    return failures == 0 ? 0 : 1;
+}
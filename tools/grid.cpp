@@ -0,0 +1,97 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the parallel grid evaluation
+ *
+ * Fills grids whose sides are not multiples of the tile, with one and several
+ * threads, through the scalar and the batch evaluators, and compares every
+ * cell with eval_function at the cell center. Exits with a non-zero status if
+ * a cell is left unwritten or differs.
+ */
+
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+
+#include <grid.h>
+
+namespace
+{
+
+using namespace sphc;
+
+struct layout
+{
+    std::size_t rows, columns;
+    grid::options opt;
+};
+
+// largest error relative to max(|f|, 1), infinite for an unwritten cell
+double grid_error(FunctionId const id, grid::equirectangular<double> const& g)
+{
+    double worst = 0.0;
+    for (std::size_t i = 0; i < g.rows; ++i)
+        for (std::size_t j = 0; j < g.columns; ++j)
+        {
+            double const exact = eval_function<double>(id, g.theta(i), g.phi(j));
+            double const value = g(i, j);
+            if (std::isnan(value) && !std::isnan(exact))
+                return std::numeric_limits<double>::infinity();
+            if (!std::isnan(exact))
+                worst = std::max(worst, std::abs(value - exact) / std::max(std::abs(exact), 1.0));
+        }
+    return worst;
+}
+
+} // namespace
+
+int main()
+{
+    layout const layouts[] =
+    {
+        { 37, 1001, { 1, 8, 512, false } },
+        { 37, 1001, { 4, 8, 512, false } },
+        { 64, 128, { 3, 5, 7, false } },
+        { 1, 3, { 2, 8, 512, false } },
+    };
+
+    int failures = 0;
+    for (layout const& l : layouts)
+    {
+        std::printf("%zu x %zu grid, %u threads, %zu x %zu tiles\n", l.rows, l.columns, l.opt.threads,
+            l.opt.tile_rows, l.opt.tile_columns);
+
+        double scalar = 0.0, batch = 0.0;
+        bool tiles = true;
+        std::size_t const expected = ((l.rows + l.opt.tile_rows - 1) / l.opt.tile_rows) *
+            ((l.columns + l.opt.tile_columns - 1) / l.opt.tile_columns);
+        for (std::size_t f = 0; f < function_count; ++f)
+        {
+            FunctionId const id = static_cast<FunctionId>(f);
+            grid::equirectangular<double> g(l.rows, l.columns);
+
+            std::fill_n(g.values.get(), l.rows * l.columns, std::numeric_limits<double>::quiet_NaN());
+            tiles = tiles && grid::evaluate<double>(get_function<double>(id), g, l.opt).tiles == expected;
+            scalar = std::max(scalar, grid_error(id, g));
+
+            // the discontinuous functions may flip at points within rounding of the jump
+            std::fill_n(g.values.get(), l.rows * l.columns, std::numeric_limits<double>::quiet_NaN());
+            tiles = tiles && grid::evaluate<double>(id, g, l.opt).tiles == expected;
+            if (id < FunctionId::d1 || id > FunctionId::d4)
+                batch = std::max(batch, grid_error(id, g));
+        }
+
+        std::printf("  %s  scalar evaluation error %.3g (bound 0)\n", scalar == 0.0 ? "ok  " : "FAIL", scalar);
+        std::printf("  %s  batch evaluation error %.3g (bound 1e-12)\n", batch <= 1e-12 ? "ok  " : "FAIL", batch);
+        std::printf("  %s  %zu tiles\n", tiles ? "ok  " : "FAIL", expected);
+        failures += (scalar == 0.0 ? 0 : 1) + (batch <= 1e-12 ? 0 : 1) + (tiles ? 0 : 1);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
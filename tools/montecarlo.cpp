@@ -0,0 +1,111 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the Monte Carlo integrator
+ *
+ * The Philox generator must reproduce the known-answer vectors of Random123,
+ * and an integration must be bit-identical on one thread and on several. For
+ * every function of the collection the estimate must lie within a few of its
+ * standard deviations of the integrals table, and the variance must match
+ * that of a uniform sample computed by a Gauss product rule. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <algorithm>
+
+#include <montecarlo.h>
+#include <quadrature.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::size_t constexpr samples = 1 << 20;
+
+// the sample variance of a million samples is within a few percent of the exact one
+double constexpr variance_bound = 0.05;
+
+// variance of a single uniform sample of 4 pi f
+double sample_variance(FunctionId const id)
+{
+    quadrature::rule<double> const& r = *quadrature::get_rule<double>(quadrature::rule_type::gauss_product, 256);
+    function_xyz<double> const fn = get_function_xyz<double>(id);
+    double squares = 0.0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        double const v = fn(r.x[i], r.y[i], r.z[i]);
+        squares += r.weight[i] * v * v;
+    }
+    double const integral = get_integral<double>(id);
+    return 4.0 * std::numbers::pi * squares - integral * integral;
+}
+
+} // namespace
+
+int main()
+{
+    struct
+    {
+        philox4x32::counter_type counter;
+        philox4x32::key_type key;
+        philox4x32::counter_type expected;
+    } const vectors[] =
+    {
+        { { 0, 0, 0, 0 }, { 0, 0 }, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff },
+            { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+        { { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 },
+            { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+
+    int failures = 0;
+    std::printf("Philox4x32-10 known-answer vectors\n");
+    for (auto const& v : vectors)
+    {
+        philox4x32::counter_type const out = philox4x32::generate(v.counter, v.key);
+        bool const ok = out == v.expected;
+        std::printf("  %s  counter %08x %08x %08x %08x, key %08x %08x\n", ok ? "ok  " : "FAIL", v.counter[0],
+            v.counter[1], v.counter[2], v.counter[3], v.key[0], v.key[1]);
+        failures += ok ? 0 : 1;
+    }
+
+    std::printf("threads\n");
+    {
+        std::size_t constexpr n = 20 * montecarlo::block_size + 17;
+        montecarlo::result<double> const one = montecarlo::integrate<double>(FunctionId::o3, n, 5, 1);
+        montecarlo::result<double> const many = montecarlo::integrate<double>(FunctionId::o3, n, 5, 3);
+        bool const same = one.estimate == many.estimate && one.variance == many.variance && one.samples == n &&
+            many.samples == n;
+        std::printf("  %s  one and three threads give bit-identical results\n", same ? "ok  " : "FAIL");
+        failures += same ? 0 : 1;
+    }
+
+    std::printf("functions of the collection (%zu samples, estimates within six standard deviations, "
+        "variances within %.0f%%)\n", samples, 100.0 * variance_bound);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        montecarlo::result<double> const r = montecarlo::integrate<double>(id, samples, 11, 1);
+        double const deviation = std::sqrt(r.variance);
+        double const error = std::abs(r.estimate - get_integral<double>(id));
+        double const variance = sample_variance(id) / static_cast<double>(samples);
+        double const ratio = r.variance / variance;
+
+        bool const ok = error <= 6.0 * deviation && std::abs(ratio - 1.0) <= variance_bound;
+        std::printf("  %s  %s error %.3g, standard deviation %.3g, variance ratio %.4f\n", ok ? "ok  " : "FAIL",
+            function_name(id).data(), error, deviation, ratio);
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the quasi-Monte Carlo point sets
+ *
+ * Integrates the analytic functions of the collection with every sequence
+ * under both mappings and compares the estimates with the integrals table.
+ * Randomized replicas must scatter around the integral as their standard
+ * error says, well below that of plain Monte Carlo with the same points, and
+ * points generated in blocks must equal those of a single call. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <span>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <algorithm>
+#include <stdexcept>
+
+#include <qmc.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::uint32_t constexpr points = 1 << 16;
+std::uint32_t constexpr replicas = 16;
+
+// Monte Carlo points reach about 1e-2 at this count; the point sets must do far better
+double constexpr bound = 1e-3;
+
+struct point_set
+{
+    char const* name;
+    qmc::sequence seq;
+};
+
+struct map
+{
+    char const* name;
+    qmc::mapping kind;
+};
+
+qmc::sampler<double> make_sampler(qmc::sequence const seq, qmc::mapping const kind)
+{
+    qmc::sampler<double> s;
+    s.seq = seq;
+    s.map = kind;
+    s.lattice_points = points;
+    return s;
+}
+
+// standard deviation of a uniform random sample of 4 pi f, from a million Sobol points
+double monte_carlo_deviation(FunctionId const id)
+{
+    std::uint32_t constexpr n = 1 << 20;
+    qmc::sampler<double> const s = make_sampler(qmc::sequence::sobol, qmc::mapping::lambert);
+    function_xyz<double> const fn = get_function_xyz<double>(id);
+    std::vector<double> x(n), y(n), z(n);
+    s.generate(0, x, y, z);
+    double sum = 0.0, squares = 0.0;
+    for (std::uint32_t i = 0; i < n; ++i)
+    {
+        double const v = 4.0 * std::numbers::pi * fn(x[i], y[i], z[i]);
+        sum += v;
+        squares += v * v;
+    }
+    double const mean = sum / n;
+    return std::sqrt(std::max(0.0, squares / n - mean * mean));
+}
+
+} // namespace
+
+int main()
+{
+    point_set const sets[] =
+    {
+        { "sobol", qmc::sequence::sobol },
+        { "halton", qmc::sequence::halton },
+        { "lattice", qmc::sequence::lattice },
+    };
+    map const maps[] =
+    {
+        { "lambert", qmc::mapping::lambert },
+        { "octahedral", qmc::mapping::octahedral },
+    };
+
+    double deviations[function_count] = {};
+    for (std::size_t f = 0; f < function_count; ++f)
+        if (get_metadata(static_cast<FunctionId>(f)).regularity == smoothness::analytic)
+            deviations[f] = monte_carlo_deviation(static_cast<FunctionId>(f));
+
+    int failures = 0;
+    for (point_set const& set : sets)
+        for (map const& m : maps)
+        {
+            qmc::sampler<double> const s = make_sampler(set.seq, m.kind);
+            std::printf("%s points, %s mapping, %u points (bound %.0g), %u randomized replicas\n", set.name, m.name,
+                points, bound, replicas);
+            for (std::size_t f = 0; f < function_count; ++f)
+            {
+                FunctionId const id = static_cast<FunctionId>(f);
+                if (get_metadata(id).regularity != smoothness::analytic)
+                    continue;
+
+                double const integral = get_integral<double>(id);
+                double const scale = std::max(std::abs(integral), 1.0);
+                double const error = std::abs(qmc::integrate(s, id, points) - integral) / scale;
+
+                // six standard errors, and at most a quarter of the Monte Carlo one
+                qmc::rqmc_result<double> const r = qmc::integrate_randomized(s, id, points, replicas);
+                double const deviation = std::abs(r.estimate - integral);
+                double const monte_carlo = deviations[f] / std::sqrt(static_cast<double>(points) * replicas);
+
+                bool const ok = error <= bound && deviation <= 6.0 * r.std_error + 1e-12 * scale &&
+                    r.std_error <= 0.25 * monte_carlo;
+                std::printf("  %s  %s error %.3g, randomized error %.3g, standard error %.3g (Monte Carlo %.3g)\n",
+                    ok ? "ok  " : "FAIL", function_name(id).data(), error, deviation, r.std_error, monte_carlo);
+                failures += ok ? 0 : 1;
+            }
+        }
+
+    // blocks of odd sizes, against one call over the whole range
+    std::printf("generation in blocks\n");
+    for (point_set const& set : sets)
+        for (map const& m : maps)
+        {
+            std::size_t constexpr n = 10007, block = 997;
+            qmc::sampler<double> s = make_sampler(set.seq, m.kind);
+            s.scrambled = true;
+            s.seed = 3;
+            std::vector<double> x(n), y(n), z(n), bx(n), by(n), bz(n);
+            s.generate(0, x, y, z);
+            for (std::size_t first = 0; first < n; first += block)
+            {
+                std::size_t const count = std::min(block, n - first);
+                s.generate(static_cast<std::uint32_t>(first), std::span(bx).subspan(first, count),
+                    std::span(by).subspan(first, count), std::span(bz).subspan(first, count));
+            }
+            bool const same = x == bx && y == by && z == bz;
+            std::printf("  %s  %s points, %s mapping\n", same ? "ok  " : "FAIL", set.name, m.name);
+            failures += same ? 0 : 1;
+        }
+
+    std::printf("rejected input\n");
+    bool rejected = false;
+    try
+    {
+        qmc::integrate_randomized(make_sampler(qmc::sequence::sobol, qmc::mapping::lambert), FunctionId::o1, 64, 1);
+    }
+    catch (std::invalid_argument const&)
+    {
+        rejected = true;
+    }
+    std::printf("  %s  a single randomized replica\n", rejected ? "ok  " : "FAIL");
+    failures += rejected ? 0 : 1;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the quadrature rules
+ *
+ * Every rule must sum its weights to 4 pi with its nodes on the unit sphere,
+ * the Lebedev and Gauss product rules must integrate the monomials up to
+ * their degree exactly, and every family must approach the integrals table
+ * of functions.h on the analytic functions. Exits with a non-zero status if
+ * any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#include <quadrature.h>
+
+namespace
+{
+
+using namespace sphc;
+
+int report(bool const ok, char const* what, double const error, double const bound)
+{
+    std::printf("  %s  %s error %.3g (bound %.0g)\n", ok ? "ok  " : "FAIL", what, error, bound);
+    return ok ? 0 : 1;
+}
+
+// integral of x^a y^b z^c over the unit sphere
+double monomial_integral(int const a, int const b, int const c)
+{
+    if (a % 2 || b % 2 || c % 2)
+        return 0.0;
+    return 2.0 * std::tgamma((a + 1) / 2.0) * std::tgamma((b + 1) / 2.0) * std::tgamma((c + 1) / 2.0) /
+        std::tgamma((a + b + c + 3) / 2.0);
+}
+
+// largest error over the monomials up to the given total degree
+double monomial_error(quadrature::rule<double> const& r, int const degree)
+{
+    double worst = 0.0;
+    for (int a = 0; a <= degree; ++a)
+        for (int b = 0; a + b <= degree; ++b)
+            for (int c = 0; a + b + c <= degree; ++c)
+            {
+                double sum = 0.0;
+                for (std::size_t i = 0; i < r.size(); ++i)
+                    sum += r.weight[i] * std::pow(r.x[i], a) * std::pow(r.y[i], b) * std::pow(r.z[i], c);
+                worst = std::max(worst, std::abs(sum - monomial_integral(a, b, c)));
+            }
+    return worst;
+}
+
+struct family
+{
+    char const* name;
+    quadrature::rule_type type;
+    std::size_t order;
+    double bound;               // on the analytic functions, absolute
+};
+
+int check_rule(char const* name, quadrature::rule<double> const& r)
+{
+    double weights = 0.0, radius = 0.0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        weights += r.weight[i];
+        radius = std::max(radius, std::abs(std::hypot(r.x[i], r.y[i], r.z[i]) - 1.0));
+    }
+    double const error = std::max(std::abs(weights - 4.0 * std::numbers::pi), radius);
+    return report(error <= 1e-10, name, error, 1e-10);
+}
+
+} // namespace
+
+int main()
+{
+    using quadrature::rule_type;
+
+    family const families[] =
+    {
+        { "gauss_product 64", rule_type::gauss_product, 64, 1e-12 },
+        { "healpix 128", rule_type::healpix, 128, 1e-4 },
+        { "icosahedral 6", rule_type::icosahedral, 6, 1e-3 },
+        { "fibonacci 200000", rule_type::fibonacci, 200000, 1e-6 },
+    };
+
+    int failures = 0;
+    std::printf("weights and nodes\n");
+    for (family const& f : families)
+        failures += check_rule(f.name, *quadrature::get_rule<double>(f.type, f.order));
+
+    std::printf("exactness on monomials\n");
+    std::size_t const lebedev[][2] = { { 6, 3 }, { 14, 5 }, { 26, 7 }, { 38, 9 }, { 50, 11 } };
+    for (auto const [points, degree] : lebedev)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "lebedev %zu, degree %zu", points, degree);
+        double const error = monomial_error(quadrature::make_rule<double>(rule_type::lebedev, points),
+            static_cast<int>(degree));
+        failures += report(error <= 1e-13, name, error, 1e-13);
+    }
+    for (std::size_t n = 1; n <= 8; ++n)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "gauss_product %zu, degree %zu", n, 2 * n - 1);
+        double const error = monomial_error(quadrature::make_rule<double>(rule_type::gauss_product, n),
+            static_cast<int>(2 * n - 1));
+        failures += report(error <= 1e-13, name, error, 1e-13);
+    }
+
+    std::printf("analytic functions against the integrals table\n");
+    for (family const& f : families)
+    {
+        double worst = 0.0;
+        for (std::size_t i = 0; i < function_count; ++i)
+        {
+            FunctionId const id = static_cast<FunctionId>(i);
+            if (get_metadata(id).regularity == smoothness::analytic)
+                worst = std::max(worst,
+                    std::abs(quadrature::integrate<double>(f.type, f.order, id) - get_integral<double>(id)));
+        }
+        failures += report(worst <= f.bound, f.name, worst, f.bound);
+    }
+
+    std::printf("cache and orders\n");
+    bool const shared = quadrature::get_rule<double>(rule_type::healpix, 128) ==
+        quadrature::get_rule<double>(rule_type::healpix, 128);
+    std::printf("  %s  repeated get_rule shares one rule\n", shared ? "ok  " : "FAIL");
+    failures += shared ? 0 : 1;
+
+    for (auto const& [type, order] : { std::pair{ rule_type::fibonacci, std::size_t(0) },
+        std::pair{ rule_type::lebedev, std::size_t(7) } })
+    {
+        bool thrown = false;
+        try
+        {
+            quadrature::make_rule<double>(type, order);
+        }
+        catch (std::invalid_argument const&)
+        {
+            thrown = true;
+        }
+        std::printf("  %s  order %zu rejected\n", thrown ? "ok  " : "FAIL", order);
+        failures += thrown ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the structure-reduced integrator
+ *
+ * Integrates every function of the collection and compares the estimate with
+ * the integrals table. Each function must be integrated by the method its
+ * metadata selects, and every reduction must converge. A converged result
+ * must lie within its estimated error, or within rounding of the table for the
+ * exact reductions. Exits with a non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+
+#include <reduced.h>
+
+namespace
+{
+
+using namespace sphc;
+
+reduced::method expected_method(function_metadata const& meta)
+{
+    if (meta.form == structure::half_space)
+        return reduced::method::cap_area;
+    if (meta.z_parity < 0)
+        return reduced::method::odd_symmetry;
+    switch (meta.form)
+    {
+        case structure::zonal:     return reduced::method::zonal;
+        case structure::azimuthal: return reduced::method::azimuthal;
+        case structure::separable: return reduced::method::separable;
+        default:                   return reduced::method::adaptive;
+    }
+}
+
+char const* method_name(reduced::method const m)
+{
+    switch (m)
+    {
+        case reduced::method::cap_area:     return "cap area";
+        case reduced::method::odd_symmetry: return "odd symmetry";
+        case reduced::method::zonal:        return "zonal";
+        case reduced::method::azimuthal:    return "azimuthal";
+        case reduced::method::separable:    return "separable";
+        default:                            return "adaptive";
+    }
+}
+
+} // namespace
+
+int main()
+{
+    adaptive::options opt;
+    opt.max_evaluations = 4'000'000;
+
+    int failures = 0;
+    std::printf("functions of the collection (tolerance %.0g, %zu evaluations)\n", opt.absolute_tolerance,
+        opt.max_evaluations);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        reduced::method const expected = expected_method(get_metadata(id));
+        reduced::result<double> const r = reduced::integrate<double>(id, opt);
+        double const integral = get_integral<double>(id);
+        double const error = std::abs(r.estimate - integral);
+
+        // the adaptive fallback is checked by tools/adaptive
+        bool ok = r.used == expected && (r.converged || expected == reduced::method::adaptive);
+        if (r.converged)
+            ok = ok && error <= std::max(static_cast<double>(r.error), 1e-12 * std::max(std::abs(integral), 1.0));
+        std::printf("  %s  %s %s, error %.3g, estimated %.3g, %s\n", ok ? "ok  " : "FAIL", function_name(id).data(),
+            method_name(r.used), error, r.error, r.converged ? "converged" : "not converged");
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
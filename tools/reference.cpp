@@ -0,0 +1,495 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Reference integrals and extremes
+ *
+ * Recomputes the integrals, maximums and minimums tables in long double:
+ *  - integrals by nested adaptive Gauss-Kronrod quadrature in (theta, phi),
+ *    with both levels split at the discontinuities and steep fronts of the
+ *    functions, so every panel integrates a smooth piece; zonal, azimuthal
+ *    and separable functions (see get_metadata) take line integrals instead,
+ *  - maxima and minima by optimize::find_maximum and find_minimum, a Sobol
+ *    scan whose best points are refined by Newton's method on the sphere.
+ * Functions are processed in parallel.
+ *
+ * Usage:
+ *   reference            print the tables in the layout of functions.h
+ *   reference --check    compare with the tables, non-zero exit on mismatch
+ *   reference --certify  check that every table extreme lies in the rigorous
+ *                        enclosure of bounds::enclose_maximum / minimum
+ */
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <numbers>
+#include <cstddef>
+#include <optional>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+
+#include <bounds.h>
+#include <optimize.h>
+#include <functions.h>
+
+namespace
+{
+
+using real = long double;
+using sphc::FunctionId;
+
+real constexpr pi = std::numbers::pi_v<real>;
+
+/**
+ * Plane n . p = offset across which a function jumps or changes steeply
+ */
+struct plane
+{
+    real nx, ny, nz;
+    real offset;
+};
+
+/**
+ * Curve g(theta, phi) = 0 along which a function has a kink
+ */
+using kink = real (*)(real theta, real phi);
+
+/**
+ * Where a function is not smooth; the integration panels are split there
+ */
+struct features
+{
+    std::vector<plane> planes;
+    std::vector<kink> kinks;
+    std::vector<real> latitudes;    // polar angles of kinks independent of phi
+};
+
+template<real (*g)(real, real, real)>
+real kink_xyz(real const theta, real const phi)
+{
+    return g(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+}
+
+// the arguments of the absolute values, with the constants of the definitions
+real a3_kink(real x, real y, real z) { return std::cos(3.0f * x) + std::sin(2.0f * y) + 0.5f * z * z; }
+real a4_kink(real x, real y, real z) { return std::sin(2.0f * x) * std::cos(3.0f * y) + 0.5f * z * z + 0.3f * std::sin(5.0f * x) * std::cos(4.0f * z); }
+real a5_kink(real x, real y, real z) { return x * x - y * y + 0.5f * x * z - 0.3f * y * z; }
+real a6_kink(real x, real y, real z) { return std::sin(10.0f * x) * std::cos(12.0f * y) * std::sin(15.0f * z) + std::cos(20.0f * x); }
+
+features function_features(FunctionId const id)
+{
+    if (std::optional<sphc::discontinuity_plane> const p = sphc::get_discontinuity_plane(id))
+        return { { { p->nx, p->ny, p->nz, p->offset } }, {}, {} };
+
+    // steep but continuous transitions across a plane
+    switch (id)
+    {
+        case FunctionId::s1: return { { { -1, -1, 1, 0 } }, {}, {} };
+        case FunctionId::s2: return { { { 0, 0, 1, 9999.0f / 10000.0f } }, {}, {} };
+        case FunctionId::s3: return { { { 0, 0, 1, 9999.0f / (10000.0f * 2.0f * std::sqrt(2)) } }, {}, {} };
+        case FunctionId::a1:
+            return { {}, { [](real t, real p) { return std::sin(std::cos(2.0f * p) - 2.0f * t); } }, { pi / 4, 3 * pi / 4 } };
+        case FunctionId::a2:
+            return { {}, { [](real t, real p) { return std::sin(2.0f * p - t); } }, { pi / 4, 3 * pi / 4 } };
+        case FunctionId::a3: return { {}, { &kink_xyz<a3_kink> }, {} };
+        case FunctionId::a4: return { {}, { &kink_xyz<a4_kink> }, {} };
+        case FunctionId::a5: return { {}, { &kink_xyz<a5_kink> }, {} };
+        case FunctionId::a6: return { {}, { &kink_xyz<a6_kink> }, {} };
+        default: return {};
+    }
+}
+
+/**
+ * Polar angles bounding the circle where a plane cuts the sphere
+ */
+void theta_breaks(plane const& p, std::vector<real>& breaks)
+{
+    real const norm = std::sqrt(p.nx * p.nx + p.ny * p.ny + p.nz * p.nz);
+    real const d = p.offset / norm;
+    if (std::abs(d) >= 1)
+        return;
+
+    real const center = std::acos(p.nz / norm);
+    real const radius = std::acos(d);
+    for (real const t : { center - radius, center + radius })
+    {
+        // a circle crossing a pole reaches its extreme angle on the far side
+        real const folded = t < 0 ? -t : (t > pi ? 2 * pi - t : t);
+        breaks.push_back(folded);
+    }
+}
+
+/**
+ * Azimuths where a plane cuts the circle of latitude theta
+ */
+void phi_breaks(plane const& p, real const theta, std::vector<real>& breaks)
+{
+    // nx sin(theta) cos(phi) + ny sin(theta) sin(phi) = offset - nz cos(theta)
+    real const a = p.nx * std::sin(theta);
+    real const b = p.ny * std::sin(theta);
+    real const c = p.offset - p.nz * std::cos(theta);
+    real const r = std::hypot(a, b);
+    if (r == 0 || std::abs(c) >= r)
+        return;
+
+    real const base = std::atan2(b, a);
+    real const spread = std::acos(c / r);
+    for (real t : { base - spread, base + spread })
+    {
+        t = std::fmod(t, 2 * pi);
+        breaks.push_back(t < 0 ? t + 2 * pi : t);
+    }
+}
+
+/**
+ * Azimuths where a kink curve crosses the circle of latitude theta, bracketed
+ * on a uniform grid and bisected to full precision
+ */
+void phi_roots(kink const g, real const theta, std::vector<real>& breaks)
+{
+    std::size_t constexpr samples = 2048;
+    real const step = 2 * pi / samples;
+
+    real left = 0;
+    real g_left = g(theta, left);
+    for (std::size_t i = 1; i <= samples; ++i)
+    {
+        real const right = static_cast<real>(i) * step;
+        real const g_right = g(theta, right);
+        if ((g_left < 0) != (g_right < 0))
+        {
+            real lo = left, hi = right;
+            bool const lo_negative = g_left < 0;
+            for (int k = 0; k < 80; ++k)
+            {
+                real const mid = (lo + hi) / 2;
+                if (mid <= lo || mid >= hi)
+                    break;
+                ((g(theta, mid) < 0) == lo_negative ? lo : hi) = mid;
+            }
+            breaks.push_back((lo + hi) / 2);
+        }
+        left = right;
+        g_left = g_right;
+    }
+}
+
+// Gauss-Kronrod 7-15 nodes and weights, the Gauss nodes are the odd Kronrod ones
+real constexpr kronrod_nodes[8] =
+{
+    0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+    0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+    0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+    0.207784955007898467600689403773245L, 0.0L
+};
+
+real constexpr kronrod_weights[8] =
+{
+    0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+    0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+    0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+    0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L
+};
+
+real constexpr gauss_weights[4] =
+{
+    0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+    0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L
+};
+
+struct panel
+{
+    real a, b;
+    real value;
+    real error;
+
+    bool operator<(panel const& other) const { return error < other.error; }
+};
+
+panel gauss_kronrod(std::function<real(real)> const& f, real const a, real const b)
+{
+    real const center = (a + b) / 2;
+    real const half = (b - a) / 2;
+
+    real const fc = f(center);
+    real kronrod = kronrod_weights[7] * fc;
+    real gauss = gauss_weights[3] * fc;
+    for (int i = 0; i < 7; ++i)
+    {
+        real const dx = half * kronrod_nodes[i];
+        real const sum = f(center - dx) + f(center + dx);
+        kronrod += kronrod_weights[i] * sum;
+        if (i % 2 == 1)
+            gauss += gauss_weights[i / 2] * sum;
+    }
+    return { a, b, kronrod * half, std::abs((kronrod - gauss) * half) };
+}
+
+struct estimate
+{
+    real value;
+    real error;
+};
+
+/**
+ * Globally adaptive quadrature over [a, b], starting from panels split at the
+ * given breakpoints and bisecting the panel with the largest error
+ */
+estimate adaptive(std::function<real(real)> const& f, real const a, real const b, std::vector<real> breaks,
+    real const abs_tol, real const rel_tol, std::size_t const max_panels)
+{
+    breaks.push_back(a);
+    breaks.push_back(b);
+    std::sort(breaks.begin(), breaks.end());
+
+    std::vector<panel> heap;
+    for (std::size_t i = 0; i + 1 < breaks.size(); ++i)
+        if (breaks[i] >= a && breaks[i + 1] <= b && breaks[i + 1] > breaks[i])
+            heap.push_back(gauss_kronrod(f, breaks[i], breaks[i + 1]));
+    std::make_heap(heap.begin(), heap.end());
+
+    // running totals steer the refinement, the result is summed again at the end
+    real value = 0, error = 0;
+    for (panel const& p : heap)
+    {
+        value += p.value;
+        error += p.error;
+    }
+
+    while (heap.size() < max_panels && error > std::max(abs_tol, rel_tol * std::abs(value)))
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        panel const worst = heap.back();
+        heap.pop_back();
+        value -= worst.value;
+        error -= worst.error;
+
+        real const mid = (worst.a + worst.b) / 2;
+        if (mid <= worst.a || mid >= worst.b)
+        {
+            // the panel cannot be split further, keep it as is
+            value += worst.value;
+            heap.push_back({ worst.a, worst.b, worst.value, 0 });
+            std::push_heap(heap.begin(), heap.end());
+            continue;
+        }
+
+        for (panel const& half : { gauss_kronrod(f, worst.a, mid), gauss_kronrod(f, mid, worst.b) })
+        {
+            value += half.value;
+            error += half.error;
+            heap.push_back(half);
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    // sum the smallest contributions first
+    std::sort(heap.begin(), heap.end(), [](panel const& l, panel const& r) { return std::abs(l.value) < std::abs(r.value); });
+    estimate total = { 0, 0 };
+    for (panel const& p : heap)
+    {
+        total.value += p.value;
+        total.error += p.error;
+    }
+    return total;
+}
+
+estimate surface_integral(FunctionId const id)
+{
+    sphc::function<real> const fn = sphc::get_function<real>(id);
+    features const f = function_features(id);
+
+    std::vector<real> outer_breaks = f.latitudes;
+    for (plane const& p : f.planes)
+        theta_breaks(p, outer_breaks);
+
+    // functions of one angle, or sums of such, reduce to line integrals
+    auto const polar = [&]()
+    {
+        return adaptive([&](real const theta) { return fn(theta, 0) * std::sin(theta); }, 0, pi, outer_breaks,
+            1e-19L, 1e-17L, 20000);
+    };
+    auto const azimuthal = [&]()
+    {
+        return adaptive([&](real const phi) { return fn(pi / 2, phi); }, 0, 2 * pi, {}, 1e-19L, 1e-17L, 20000);
+    };
+    switch (sphc::get_metadata(id).form)
+    {
+        case sphc::structure::zonal:
+        {
+            estimate const t = polar();
+            return { 2 * pi * t.value, 2 * pi * t.error };
+        }
+        case sphc::structure::azimuthal:
+        {
+            estimate const p = azimuthal();
+            return { 2 * p.value, 2 * p.error };
+        }
+        case sphc::structure::separable:
+        {
+            estimate const t = polar(), p = azimuthal();
+            return { 2 * pi * t.value + 2 * p.value - 4 * pi * fn(pi / 2, 0), 2 * pi * t.error + 2 * p.error };
+        }
+        default:
+            break;
+    }
+
+    real inner_error = 0;
+    auto const ring = [&](real const theta)
+    {
+        std::vector<real> inner_breaks;
+        for (plane const& p : f.planes)
+            phi_breaks(p, theta, inner_breaks);
+        for (kink const g : f.kinks)
+            phi_roots(g, theta, inner_breaks);
+
+        estimate const e = adaptive([&](real const phi) { return fn(theta, phi); }, 0, 2 * pi, inner_breaks,
+            1e-19L, 1e-17L, 20000);
+        inner_error = std::max(inner_error, e.error);
+        return e.value * std::sin(theta);
+    };
+
+    estimate e = adaptive(ring, 0, pi, outer_breaks, 1e-16L, 1e-15L, 20000);
+    e.error += 2 * pi * pi * inner_error;
+    return e;
+}
+
+real global_extreme(FunctionId const id, sphc::optimize::goal const goal)
+{
+    sphc::optimize::options opt;
+    opt.threads = 1;
+    return goal == sphc::optimize::goal::maximum ? sphc::optimize::find_maximum<real>(id, opt).value :
+        sphc::optimize::find_minimum<real>(id, opt).value;
+}
+
+struct reference
+{
+    estimate integral;
+    real maximum;
+    real minimum;
+};
+
+void print_table(char const* name, std::vector<reference> const& refs, real reference::* const extreme)
+{
+    std::printf("inline constexpr std::array<double, function_count> %s =\n{\n", name);
+    for (std::size_t i = 0; i < refs.size(); ++i)
+    {
+        real v = extreme ? refs[i].*extreme : refs[i].integral.value;
+        // an integral indistinguishable from zero vanishes by symmetry
+        if (!extreme && std::abs(v) <= refs[i].integral.error)
+            v = 0;
+
+        // shortest representation that round-trips to the same double
+        char value[64];
+        char* end = std::to_chars(value, value + sizeof(value) - 2, static_cast<double>(v)).ptr;
+        if (i + 1 < refs.size())
+            *end++ = ',';
+        *end = '\0';
+        std::printf("    %-33s// %s\n", value, sphc::function_name(static_cast<FunctionId>(i)).data());
+    }
+    std::printf("};\n\n");
+}
+
+/**
+ * Check the maximums and minimums tables against interval branch and bound
+ *
+ * The tables hold the extremes of the long double templates, the enclosures
+ * bound the double ones, so the inner end gets a slack of 1e-12.
+ */
+int certify(double const tolerance)
+{
+    sphc::bounds::search_options opt;
+    opt.tolerance = tolerance;
+
+    int failures = 0;
+    auto check = [&](char const* name, FunctionId const id, double const value,
+        sphc::bounds::enclosure<double> const& e, bool const maximum)
+    {
+        double const slack = 1e-12 * std::max(1.0, std::abs(value));
+        bool const ok = value >= e.value.lo - (maximum ? slack : 0) && value <= e.value.hi + (maximum ? 0 : slack);
+        std::printf("%s  %-2s  %s %.17g in [%.17g, %.17g]%s\n", ok ? "ok  " : "FAIL", sphc::function_name(id).data(),
+            name, value, e.value.lo, e.value.hi, e.converged ? "" : " (not converged)");
+        failures += ok ? 0 : 1;
+    };
+
+    for (std::size_t i = 0; i < sphc::function_count; ++i)
+    {
+        FunctionId const id = static_cast<FunctionId>(i);
+        check("maximum", id, sphc::get_maximum<double>(id), sphc::bounds::enclose_maximum<double>(id, opt), true);
+        check("minimum", id, sphc::get_minimum<double>(id), sphc::bounds::enclose_minimum<double>(id, opt), false);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--certify") == 0)
+        return certify(argc > 2 ? std::atof(argv[2]) : 1e-6);
+
+    bool const check = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+    double const tolerance = argc > 2 ? std::atof(argv[2]) : 1e-12;
+
+    std::vector<reference> refs(sphc::function_count);
+    std::atomic<std::size_t> next = 0;
+
+    auto worker = [&]()
+    {
+        for (std::size_t i = next++; i < sphc::function_count; i = next++)
+        {
+            FunctionId const id = static_cast<FunctionId>(i);
+            refs[i] = { surface_integral(id), global_extreme(id, sphc::optimize::goal::maximum),
+                global_extreme(id, sphc::optimize::goal::minimum) };
+        }
+    };
+
+    unsigned const threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    if (!check)
+    {
+        print_table("integrals", refs, nullptr);
+        print_table("maximums", refs, &reference::maximum);
+        print_table("minimums", refs, &reference::minimum);
+        for (std::size_t i = 0; i < refs.size(); ++i)
+            std::fprintf(stderr, "%s: integral error estimate %.3Lg\n",
+                sphc::function_name(static_cast<FunctionId>(i)).data(), refs[i].integral.error);
+        return 0;
+    }
+
+    int failures = 0;
+    for (std::size_t i = 0; i < refs.size(); ++i)
+    {
+        FunctionId const id = static_cast<FunctionId>(i);
+        double const integral = static_cast<double>(refs[i].integral.value);
+        double const maximum = static_cast<double>(refs[i].maximum);
+        double const minimum = static_cast<double>(refs[i].minimum);
+        double const integral_diff = std::abs(integral - sphc::get_integral<double>(id));
+        double const maximum_diff = std::abs(maximum - sphc::get_maximum<double>(id));
+        double const minimum_diff = std::abs(minimum - sphc::get_minimum<double>(id));
+        bool const ok = integral_diff <= tolerance * std::max(1.0, std::abs(integral)) &&
+            maximum_diff <= tolerance * std::max(1.0, std::abs(maximum)) &&
+            minimum_diff <= tolerance * std::max(1.0, std::abs(minimum));
+        std::printf("%s  %-2s  integral %.17g (diff %.2g)  maximum %.17g (diff %.2g)  minimum %.17g (diff %.2g)\n",
+            ok ? "ok  " : "FAIL", sphc::function_name(id).data(), integral, integral_diff, maximum, maximum_diff,
+            minimum, minimum_diff);
+        failures += ok ? 0 : 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the rotated functions
+ *
+ * The random rotations must be proper and orthonormal, with a mean of zero as
+ * uniform rotations have, and a family must be the same rotations however it
+ * is split. The tiled batch evaluation must agree with the scalar rotated
+ * functions, and the integrals of rotated analytic functions must stay those
+ * of the integrals table. Exits with a non-zero status if any check fails.
+ */
+
+#include <span>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include <rotation.h>
+#include <quadrature.h>
+
+namespace
+{
+
+using namespace sphc;
+
+int report(bool const ok, char const* what, double const error, double const bound)
+{
+    std::printf("  %s  %s error %.3g (bound %.0g)\n", ok ? "ok  " : "FAIL", what, error, bound);
+    return ok ? 0 : 1;
+}
+
+double determinant(rotation::matrix<double> const& r)
+{
+    auto const& m = r.m;
+    return m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) +
+        m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+} // namespace
+
+int main()
+{
+    std::size_t constexpr count = 1 << 16;
+    std::vector<rotation::matrix<double>> const family = rotation::uniform_family<double>(9, count);
+
+    int failures = 0;
+    std::printf("%zu uniform rotations\n", count);
+    double orthonormal = 0.0;
+    double mean[9] = {};
+    for (rotation::matrix<double> const& r : family)
+    {
+        rotation::matrix<double> const t = r.transposed();
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                double const dot = r.m[3 * i] * t.m[j] + r.m[3 * i + 1] * t.m[3 + j] + r.m[3 * i + 2] * t.m[6 + j];
+                orthonormal = std::max(orthonormal, std::abs(dot - (i == j ? 1.0 : 0.0)));
+            }
+        orthonormal = std::max(orthonormal, std::abs(determinant(r) - 1.0));
+        for (std::size_t k = 0; k < 9; ++k)
+            mean[k] += r.m[k] / static_cast<double>(count);
+    }
+    failures += report(orthonormal <= 1e-14, "orthonormality and determinant", orthonormal, 1e-14);
+
+    // every entry of a uniform rotation has mean 0 and variance 1/3; six standard deviations
+    double const mean_bound = 6.0 / std::sqrt(3.0 * count);
+    double const mean_error = std::abs(*std::max_element(mean, mean + 9, [](double const a, double const b)
+    {
+        return std::abs(a) < std::abs(b);
+    }));
+    failures += report(mean_error <= mean_bound, "mean of the entries", mean_error, mean_bound);
+
+    std::vector<rotation::matrix<double>> const tail = rotation::uniform_family<double>(9, 100, count - 100);
+    bool const split = std::equal(tail.begin(), tail.end(), family.end() - 100,
+        [](rotation::matrix<double> const& a, rotation::matrix<double> const& b) { return a.m == b.m; });
+    std::printf("  %s  a family does not depend on its split\n", split ? "ok  " : "FAIL");
+    failures += split ? 0 : 1;
+
+    // points of a Gauss product rule serve both as evaluation points and for the integrals
+    quadrature::rule<double> const& r = *quadrature::get_rule<double>(quadrature::rule_type::gauss_product, 128);
+    std::size_t const points = r.size();
+    std::size_t constexpr rotations = 40;           // more than one tile of rotations
+    std::span<rotation::matrix<double> const> const some(family.data(), rotations);
+    std::vector<double> values(rotations * points);
+
+    std::printf("batch evaluation of %zu rotations at %zu points against the scalar rotated functions\n", rotations,
+        points);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        rotation::eval_batch_xyz<double>(id, some, r.x, r.y, r.z, values, 3);
+
+        // the discontinuous functions may flip at points within rounding of the jump
+        double worst = 0.0;
+        if (id < FunctionId::d1 || id > FunctionId::d4)
+        {
+            for (std::size_t i = 0; i < rotations; i += 13)
+            {
+                rotation::rotated<double> const g(id, some[i]);
+                for (std::size_t j = 0; j < points; ++j)
+                {
+                    double const exact = g(r.x[j], r.y[j], r.z[j]);
+                    worst = std::max(worst, std::abs(values[i * points + j] - exact) / std::max(std::abs(exact), 1.0));
+                }
+            }
+        }
+
+        // integrals of the rotated copies, for the analytic functions
+        double integral = 0.0;
+        if (get_metadata(id).regularity == smoothness::analytic)
+        {
+            for (std::size_t i = 0; i < rotations; ++i)
+            {
+                double sum = 0.0;
+                for (std::size_t j = 0; j < points; ++j)
+                    sum += r.weight[j] * values[i * points + j];
+                integral = std::max(integral, std::abs(sum - get_integral<double>(id)));
+            }
+        }
+
+        bool const ok = worst <= 1e-12 && integral <= 1e-10;
+        std::printf("  %s  %s error %.3g (bound 1e-12), integral error %.3g (bound 1e-10)\n", ok ? "ok  " : "FAIL",
+            function_name(id).data(), worst, integral);
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the samplers
+ *
+ * Draws directions from every function of the collection, tabulated and,
+ * where the acceptance rate allows, by rejection, and compares the mean
+ * direction with that of the positive part of the function, computed by a
+ * Gauss product rule. The acceptance rates, the normalization of the
+ * tabulated density and the independence of the streams from the thread
+ * count and the split of the range are checked as well. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <array>
+#include <cstdio>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+
+#include <sampling.h>
+#include <quadrature.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::size_t constexpr samples = 1 << 18;
+
+// six standard deviations of the mean of a unit vector component, plus the
+// errors of the table cells and of the reference at the jumps
+double constexpr mean_bound = 6.0 / 512.0 + 5e-3;
+
+struct moments
+{
+    double integral;                    // of the positive part
+    std::array<double, 3> mean;         // direction
+};
+
+moments reference_moments(FunctionId const id)
+{
+    quadrature::rule<double> const& r = *quadrature::get_rule<double>(quadrature::rule_type::gauss_product, 256);
+    function_xyz<double> const fn = get_function_xyz<double>(id);
+    moments m{ 0.0, { 0.0, 0.0, 0.0 } };
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        double const w = r.weight[i] * std::max(0.0, fn(r.x[i], r.y[i], r.z[i]));
+        m.integral += w;
+        m.mean[0] += w * r.x[i];
+        m.mean[1] += w * r.y[i];
+        m.mean[2] += w * r.z[i];
+    }
+    for (double& c : m.mean)
+        c /= m.integral;
+    return m;
+}
+
+// largest difference of the mean of the samples from the reference
+double mean_error(std::vector<double> const& x, std::vector<double> const& y, std::vector<double> const& z,
+    moments const& m)
+{
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        sx += x[i];
+        sy += y[i];
+        sz += z[i];
+    }
+    double const n = static_cast<double>(x.size());
+    return std::max({ std::abs(sx / n - m.mean[0]), std::abs(sy / n - m.mean[1]), std::abs(sz / n - m.mean[2]) });
+}
+
+// total solid angle density by the Gauss product rule, 1 for a normalized density
+double density_total(sampling::tabulated_distribution const& d)
+{
+    quadrature::rule<double> const& r = *quadrature::get_rule<double>(quadrature::rule_type::gauss_product, 256);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+        sum += r.weight[i] * sampling::pdf(d, r.x[i], r.y[i], r.z[i]);
+    return sum;
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<double> x(samples), y(samples), z(samples);
+
+    int failures = 0;
+    std::printf("mean directions of %zu samples (bound %.2g)\n", samples, mean_bound);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        moments const m = reference_moments(id);
+
+        sampling::tabulated_distribution const d = sampling::make_tabulated<double>(id);
+        sampling::sample_tabulated<double>(d, x, y, z, 1);
+        double const tabulated = mean_error(x, y, z, m);
+        double const total = std::abs(density_total(d) - 1.0);
+        bool ok = tabulated <= mean_bound && total <= 1e-2;
+
+        // rejection against the tabulated maximum, where it accepts often enough
+        char rejection[96] = "";
+        double const rate = m.integral / (4.0 * std::numbers::pi * get_maximum<double>(id) * 1.00001);
+        if (rate >= 0.02)
+        {
+            sampling::sample_stats const s = sampling::sample_rejection<double>(id, x, y, z, 1);
+            double const error = mean_error(x, y, z, m);
+            ok = ok && error <= mean_bound && std::abs(s.acceptance_rate - rate) <= 1e-2 * rate;
+            std::snprintf(rejection, sizeof(rejection), ", rejection %.3g, acceptance rate %.3g (expected %.3g)",
+                error, s.acceptance_rate, rate);
+        }
+        std::printf("  %s  %s tabulated %.3g, density total error %.3g%s\n", ok ? "ok  " : "FAIL",
+            function_name(id).data(), tabulated, total, rejection);
+        failures += ok ? 0 : 1;
+    }
+
+    std::printf("streams\n");
+    {
+        std::size_t constexpr n = 100000;
+        std::vector<double> a(3 * n), b(3 * n);
+        sampling::sample_rejection<double>(FunctionId::o1, std::span(a).first(n), std::span(a).subspan(n, n),
+            std::span(a).last(n), 7, 1);
+        sampling::sample_rejection<double>(FunctionId::o1, std::span(b).first(n), std::span(b).subspan(n, n),
+            std::span(b).last(n), 7, 3);
+        bool const threads = a == b;
+        std::printf("  %s  rejection samples do not depend on the thread count\n", threads ? "ok  " : "FAIL");
+
+        sampling::tabulated_distribution const d = sampling::make_tabulated<double>(FunctionId::o1, 64, 128);
+        sampling::sample_tabulated<double>(d, std::span(a).first(n), std::span(a).subspan(n, n),
+            std::span(a).last(n), 7);
+        std::size_t constexpr half = n / 2;
+        for (std::size_t const first : { std::size_t(0), half })
+            sampling::sample_tabulated<double>(d, std::span(b).subspan(first, half),
+                std::span(b).subspan(n + first, half), std::span(b).subspan(2 * n + first, half), 7, first);
+        bool const split = a == b;
+        std::printf("  %s  tabulated samples do not depend on the split of the range\n", split ? "ok  " : "FAIL");
+        failures += (threads ? 0 : 1) + (split ? 0 : 1);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the spherical harmonic transform
+ *
+ * The polynomial functions p1, z2 and z3 are band-limited, so their spectra
+ * must synthesize them to rounding. For every analytic function a_00 must
+ * match the integrals table, the energy must match the integral of f^2
+ * (Parseval) and the synthesis must approach the function. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+
+#include <sht.h>
+
+namespace
+{
+
+using namespace sphc;
+
+int report(bool const ok, char const* what, double const error, double const bound)
+{
+    std::printf("  %s  %s error %.3g (bound %.0g)\n", ok ? "ok  " : "FAIL", what, error, bound);
+    return ok ? 0 : 1;
+}
+
+// largest synthesis error at random directions
+double synthesis_error(FunctionId const id, sht::spectrum const& s)
+{
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+
+    double worst = 0.0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        double const theta = std::acos(1.0 - 2.0 * u(rng));
+        double const phi = 2.0 * std::numbers::pi * u(rng);
+        worst = std::max(worst, std::abs(sht::synthesize(s, theta, phi) - eval_function<double>(id, theta, phi)));
+    }
+    return worst;
+}
+
+// integral of f^2 by a Gauss product rule finer than the transform
+double squared_integral(FunctionId const id)
+{
+    quadrature::rule<double> const& r = *quadrature::get_rule<double>(quadrature::rule_type::gauss_product, 256);
+    function_xyz<double> const fn = get_function_xyz<double>(id);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        double const f = fn(r.x[i], r.y[i], r.z[i]);
+        sum += r.weight[i] * f * f;
+    }
+    return sum;
+}
+
+} // namespace
+
+int main()
+{
+    std::size_t constexpr bandlimit = 64;
+    int failures = 0;
+
+    std::printf("band-limited functions, bandlimit 32\n");
+    for (FunctionId const id : { FunctionId::p1, FunctionId::z2, FunctionId::z3 })
+    {
+        double const error = synthesis_error(id, sht::analyze<double>(id, 32));
+        failures += report(error <= 1e-12, function_name(id).data(), error, 1e-12);
+    }
+
+    std::printf("analytic functions, bandlimit %zu\n", bandlimit);
+    std::vector<sht::spectrum> const spectra = sht::analyze_all<double>(bandlimit);
+    for (std::size_t f = 0; f < function_count; ++f)
+    {
+        FunctionId const id = static_cast<FunctionId>(f);
+        if (get_metadata(id).regularity != smoothness::analytic)
+            continue;
+
+        sht::spectrum const& s = spectra[f];
+        double const integral = s.coefficient(0, 0).real() * std::sqrt(4.0 * std::numbers::pi);
+        double energy = 0.0;
+        for (double const e : s.energy)
+            energy += e;
+        double const squared = squared_integral(id);
+
+        double const a00 = std::abs(integral - get_integral<double>(id));
+        double const parseval = std::abs(energy - squared) / std::max(squared, 1.0);
+        double const synthesis = synthesis_error(id, s);
+        bool const ok = a00 <= 1e-12 && parseval <= 1e-10 && synthesis <= 1e-6;
+        std::printf("  %s  %s a_00 error %.3g (bound 1e-12), Parseval %.3g (bound 1e-10), synthesis %.3g (bound 1e-06)\n",
+            ok ? "ok  " : "FAIL", function_name(id).data(), a00, parseval, synthesis);
+        failures += ok ? 0 : 1;
+    }
+
+    std::printf("threads\n");
+    sht::spectrum const serial = sht::analyze<double>(FunctionId::o3, bandlimit, 1);
+    sht::spectrum const parallel = sht::analyze<double>(FunctionId::o3, bandlimit, 4);
+    bool const same = serial.coefficients == parallel.coefficients;
+    std::printf("  %s  one and four threads give the same coefficients\n", same ? "ok  " : "FAIL");
+    failures += same ? 0 : 1;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Checks of the tabulated functions
+ *
+ * For every layout, random lookups of analytic functions must stay within a
+ * few percent of the errors the table reports, the batch lookup must agree
+ * with the scalar one, and a table must survive a save and load round trip
+ * unchanged. Malformed streams and resolutions must be rejected. Exits with a
+ * non-zero status if any check fails.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <numbers>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <table.h>
+
+namespace
+{
+
+using namespace sphc;
+
+std::size_t constexpr lookups = 1 << 16;
+
+// the reported errors are sampled in every cell, within a few percent of the largest
+double constexpr margin = 1.05;
+
+struct directions
+{
+    std::vector<double> x, y, z;
+};
+
+directions random_directions()
+{
+    std::mt19937_64 rng(4);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    directions d{ std::vector<double>(lookups), std::vector<double>(lookups), std::vector<double>(lookups) };
+    for (std::size_t i = 0; i < lookups; ++i)
+    {
+        double const z = 1.0 - 2.0 * u(rng);
+        double const r = std::sqrt(1.0 - z * z);
+        double const phi = 2.0 * std::numbers::pi * u(rng);
+        d.x[i] = r * std::cos(phi);
+        d.y[i] = r * std::sin(phi);
+        d.z[i] = z;
+    }
+    return d;
+}
+
+// largest error of the batch lookup, and largest difference from the scalar lookup
+void lookup_errors(table::tabulated<double> const& t, directions const& d, table::interpolation const mode,
+    double& error, double& mismatch)
+{
+    std::vector<double> values(lookups);
+    table::lookup_batch<double>(t, d.x, d.y, d.z, values, mode);
+    function_xyz<double> const fn = get_function_xyz<double>(t.id);
+
+    error = 0.0;
+    mismatch = 0.0;
+    for (std::size_t i = 0; i < lookups; ++i)
+    {
+        error = std::max(error, std::abs(values[i] - fn(d.x[i], d.y[i], d.z[i])));
+        mismatch = std::max(mismatch, std::abs(values[i] - table::lookup(t, d.x[i], d.y[i], d.z[i], mode)));
+    }
+}
+
+template<typename Fn>
+bool throws(Fn const& fn)
+{
+    try
+    {
+        fn();
+    }
+    catch (std::exception const&)
+    {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    struct
+    {
+        char const* name;
+        table::layout kind;
+    } const layouts[] =
+    {
+        { "equirectangular", table::layout::equirectangular },
+        { "octahedral", table::layout::octahedral },
+        { "cubemap", table::layout::cubemap },
+    };
+    FunctionId const functions[] = { FunctionId::p1, FunctionId::o1, FunctionId::o3, FunctionId::l1, FunctionId::l3 };
+
+    directions const d = random_directions();
+    int failures = 0;
+    for (auto const& l : layouts)
+    {
+        std::printf("%s, resolution 128, errors of %zu lookups against %.3g times the reported ones\n", l.name,
+            lookups, margin);
+        for (FunctionId const id : functions)
+        {
+            table::tabulated<double> const t = table::make_table<double>(id, l.kind, 128);
+            double bilinear, bicubic, bilinear_mismatch, bicubic_mismatch;
+            lookup_errors(t, d, table::interpolation::bilinear, bilinear, bilinear_mismatch);
+            lookup_errors(t, d, table::interpolation::bicubic, bicubic, bicubic_mismatch);
+
+            bool const ok = bilinear <= margin * t.max_error_bilinear && bicubic <= margin * t.max_error_bicubic &&
+                std::max(bilinear_mismatch, bicubic_mismatch) <= 1e-12;
+            std::printf("  %s  %s bilinear %.3g (reported %.3g), bicubic %.3g (reported %.3g), batch against scalar %.3g\n",
+                ok ? "ok  " : "FAIL", function_name(id).data(), bilinear, t.max_error_bilinear, bicubic,
+                t.max_error_bicubic, std::max(bilinear_mismatch, bicubic_mismatch));
+            failures += ok ? 0 : 1;
+        }
+
+        table::tabulated<double> const t = table::make_table<double>(FunctionId::o3, l.kind, 32);
+        std::stringstream stream;
+        table::save(t, stream);
+        table::tabulated<double> const loaded = table::load<double>(stream);
+        bool const same = loaded.id == t.id && loaded.kind == t.kind && loaded.width == t.width &&
+            loaded.height == t.height && loaded.faces == t.faces && loaded.face_size == t.face_size &&
+            loaded.max_error_bilinear == t.max_error_bilinear && loaded.max_error_bicubic == t.max_error_bicubic &&
+            loaded.texels == t.texels &&
+            table::lookup(loaded, 0.48, 0.6, 0.64, table::interpolation::bicubic) ==
+                table::lookup(t, 0.48, 0.6, 0.64, table::interpolation::bicubic);
+        std::printf("  %s  save and load round trip\n", same ? "ok  " : "FAIL");
+        failures += same ? 0 : 1;
+    }
+
+    std::printf("rejected input\n");
+    std::stringstream saved;
+    table::save(table::make_table<double>(FunctionId::o3, table::layout::octahedral, 16), saved);
+    std::string const bytes = saved.str();
+    struct
+    {
+        char const* what;
+        bool rejected;
+    } const cases[] =
+    {
+        { "foreign stream", throws([&]() { std::stringstream s("not a table at all"); table::load<double>(s); }) },
+        { "truncated stream", throws([&]()
+            {
+                std::stringstream s(bytes.substr(0, bytes.size() - 1));
+                table::load<double>(s);
+            }) },
+        { "other floating point type", throws([&]() { std::stringstream s(bytes); table::load<float>(s); }) },
+        { "zero resolution", throws([]() { table::make_table<double>(FunctionId::o3, table::layout::cubemap, 0); }) },
+    };
+    for (auto const& c : cases)
+    {
+        std::printf("  %s  %s\n", c.rejected ? "ok  " : "FAIL", c.what);
+        failures += c.rejected ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
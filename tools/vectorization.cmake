@@ -0,0 +1,61 @@
+# Check that the batch kernels of every instruction set level vectorize
+#
+# Compiles vectorization.cpp for float and double with GCC's -fopt-info-vec-missed
+# and counts the kernel loops it could not vectorize at each SPHC_DEFINE_KERNELS
+# line of simd.h. Fails when a count exceeds its allowance below.
+#
+# Usage: cmake -DCOMPILER=<g++> -DSOURCE=<vectorization.cpp> -DINCLUDE=<include dir> -P vectorization.cmake
+
+# The generic kernel targets the x86-64 baseline. SSE2 cannot turn a double
+# comparison into a 64-bit integer mask, so the double kernels that select
+# stay scalar there; sse42 is the first level that vectorizes them all.
+set(ALLOWED_float_generic 4)
+set(ALLOWED_double_generic 110)
+
+# kernel levels by their line in simd.h
+file(READ "${INCLUDE}/simd.h" SIMD)
+string(REGEX MATCHALL "\nSPHC_DEFINE_KERNELS\\([a-z0-9]+," DEFINITIONS "${SIMD}")
+if(NOT DEFINITIONS)
+    message(FATAL_ERROR "no SPHC_DEFINE_KERNELS lines in ${INCLUDE}/simd.h")
+endif()
+set(LEVELS "")
+foreach(DEFINITION IN LISTS DEFINITIONS)
+    string(REGEX REPLACE "^\nSPHC_DEFINE_KERNELS\\(([a-z0-9]+),$" "\\1" LEVEL "${DEFINITION}")
+    string(FIND "${SIMD}" "${DEFINITION}" OFFSET)
+    string(SUBSTRING "${SIMD}" 0 ${OFFSET} BEFORE)
+    string(REGEX MATCHALL "\n" NEWLINES "${BEFORE}")
+    list(LENGTH NEWLINES LINE)
+    math(EXPR LINE "${LINE} + 2")
+    list(APPEND LEVELS ${LEVEL})
+    set(LEVEL_LINE_${LEVEL} ${LINE})
+endforeach()
+
+set(FAILED FALSE)
+foreach(FLOAT float double)
+    execute_process(
+        COMMAND ${COMPILER} -std=gnu++20 -O2 -fopenmp-simd -DSPHC_OPENMP_SIMD -DSPHC_CHECK_FLOAT=${FLOAT}
+            -I${INCLUDE} -fopt-info-vec-missed -c ${SOURCE} -o vectorization_${FLOAT}.o
+        RESULT_VARIABLE RESULT
+        OUTPUT_VARIABLE REPORT
+        ERROR_VARIABLE REPORT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "compiling ${SOURCE} for ${FLOAT} failed:\n${REPORT}")
+    endif()
+
+    foreach(LEVEL IN LISTS LEVELS)
+        string(REGEX MATCHALL "simd\\.h:${LEVEL_LINE_${LEVEL}}:[0-9]+: missed: couldn't vectorize loop" MISSED "${REPORT}")
+        list(LENGTH MISSED COUNT)
+        set(ALLOWED 0)
+        if(DEFINED ALLOWED_${FLOAT}_${LEVEL})
+            set(ALLOWED ${ALLOWED_${FLOAT}_${LEVEL}})
+        endif()
+        message(STATUS "${FLOAT} ${LEVEL}: ${COUNT} scalar kernel loops (allowed ${ALLOWED})")
+        if(COUNT GREATER ALLOWED)
+            set(FAILED TRUE)
+        endif()
+    endforeach()
+endforeach()
+
+if(FAILED)
+    message(FATAL_ERROR "batch kernels stopped vectorizing, see the counts above")
+endif()
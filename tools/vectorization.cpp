@@ -0,0 +1,33 @@
+/**
+ * A collection of spherical functions
+ *
+ * Copyright (c) 2025-2026, Michal Vlnas
+ */
+
+/**
+ * Instantiation of every batch kernel, values and gradients, for the
+ * vectorization check
+ *
+ * Compiled, never linked, by vectorization.cmake with SPHC_CHECK_FLOAT set to
+ * float or double; the compiler reports every kernel loop it could not
+ * vectorize.
+ */
+
+#include <cstddef>
+
+#include <autodiff.h>
+#include <functions.h>
+
+template<typename Math>
+void instantiate(std::span<SPHC_CHECK_FLOAT const> in, std::span<SPHC_CHECK_FLOAT> out)
+{
+    for (std::size_t i = 0; i < sphc::function_count; ++i)
+    {
+        sphc::function_table<SPHC_CHECK_FLOAT, Math>[i].batch(in, in, out);
+        sphc::function_table<SPHC_CHECK_FLOAT, Math>[i].batch_xyz(in, in, in, out);
+        sphc::autodiff::autodiff_table<SPHC_CHECK_FLOAT, Math>[i].batch_gradient(in, in, in, out, out, out, out);
+    }
+}
+
+template void instantiate<sphc::vector_math>(std::span<SPHC_CHECK_FLOAT const>, std::span<SPHC_CHECK_FLOAT>);
+template void instantiate<sphc::fast_math>(std::span<SPHC_CHECK_FLOAT const>, std::span<SPHC_CHECK_FLOAT>);